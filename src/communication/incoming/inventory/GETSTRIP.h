@@ -5,12 +5,9 @@
 
 // Credits to Nillus from Woodpecker v3, very helpful code!
 void GETSTRIP(session *player, incoming_message *im) {
-    char *strip_view = im_get_content(im);
+    int length;
+    const char *strip_view = im_get_content_view(im, &length);
 
     inventory *inv = (inventory *) player->inventory;
     inventory_send(inv, strip_view, player);
-
-    if (strip_view != NULL) {
-        free(strip_view);
-    }
 }
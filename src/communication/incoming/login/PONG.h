@@ -1,6 +1,9 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
 
+/*
+ * Run by the loop owning the session, which also runs the ping timer
+ */
 void PONG(session *player, incoming_message *message) {
     player->ping_safe = true;
 }
\ No newline at end of file
@@ -38,6 +38,7 @@ void MESSENGER_ACCEPTBUDDY(session *player, incoming_message *message) {
 
         if (friend != NULL) {
             messenger_remove_request(friend->messenger, player->player_data->id);
+            player_release(friend);
         }
     }
 }
@@ -16,6 +16,7 @@ void remove_friend(session *player, int friend_id) {
 
     if (friend != NULL) {
         messenger_remove_request((messenger *) friend->messenger, friend_id);
+        player_release(friend);
     }
 }
 
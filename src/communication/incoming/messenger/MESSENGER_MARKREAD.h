@@ -2,8 +2,14 @@
 
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 void MESSENGER_MARKREAD(session *p, incoming_message *message) {
-    int message_id = im_read_vl64(message);
-    messenger_query_mark_read(message_id);
+    messenger_mark_read_packet packet;
+
+    if (!messenger_mark_read_packet_decode(message, &packet)) {
+        return;
+    }
+
+    messenger_query_mark_read(packet.message_id);
 }
@@ -2,6 +2,7 @@
 
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "game/messenger/messenger.h"
 #include "game/player/player.h"
@@ -9,30 +10,29 @@
 #include "database/queries/messenger_query.h"
 
 void MESSENGER_REMOVEBUDDY(session *player, incoming_message *message) {
-    im_read(message, 1); // garbage data
+    messenger_remove_buddy_packet packet;
 
-    int friend_id = im_read_vl64(message);
+    if (!messenger_remove_buddy_packet_decode(message, &packet)) {
+        return;
+    }
+
+    int friend_id = packet.friend_id;
 
     if (!messenger_is_friends(player->messenger, friend_id)) {
         return;
     }
 
-    outgoing_message *response = om_create(138); // "BJ"
-    om_write_int(response, 1);
-    om_write_int(response, friend_id);
-    player_send(player, response);
-    om_cleanup(response);
+    buddy_removed_packet response = { 1, friend_id };
+    buddy_removed_packet_send(player, &response); // "BJ"
 
     session *friend = player_manager_find_by_id(friend_id);
 
     if (friend != NULL) {    
-        response = om_create(138); // "BJ"
-        om_write_int(response, 1);
-        om_write_int(response, player->player_data->id);
-        player_send(friend, response);
-        om_cleanup(response);
+        response.user_id = player->player_data->id;
+        buddy_removed_packet_send(friend, &response); // "BJ"
 
         messenger_remove_friend(friend->messenger, friend_id);
+        player_release(friend);
     }
 
     messenger_remove_friend(player->messenger, friend_id);
@@ -1,43 +1,47 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "database/queries/messenger_query.h"
 
 #include "log.h"
 
 void MESSENGER_REQUESTBUDDY(session *player, incoming_message *message) {
-    char *input_search = im_read_str(message);
+    messenger_request_buddy_packet packet;
+
+    if (!messenger_request_buddy_packet_decode(message, &packet)) {
+        return;
+    }
+
+    char input_search[256];
+    packet_string_copy(&packet.username, input_search, sizeof(input_search));
+
     int search_id = player_query_id(input_search);
 
     if (search_id == -1) {
-        goto cleanup;
+        return;
     }
 
     if (messenger_is_friends(player->messenger, search_id)) {
-        goto cleanup;
+        return;
     }
 
     if (messenger_query_request_exists(player->player_data->id, search_id) ||
         messenger_query_request_exists(search_id, player->player_data->id)) {
-        goto cleanup;
+        return;
     }
 
     if (!messenger_query_new_request(player->player_data->id, search_id)) {
-        goto cleanup;
+        return;
     }
 
     session *requested_player = player_manager_find_by_id(search_id);
 
     if (requested_player != NULL) {
-        outgoing_message *response = om_create(132); // "BD"
-        om_write_int(response, player->player_data->id);
-        om_write_str(response, player->player_data->username);
-        player_send(requested_player, response);
-        om_cleanup(response);
+        buddy_request_packet response = { player->player_data->id, player->player_data->username };
+        buddy_request_packet_send(requested_player, &response); // "BD"
 
         list_add(requested_player->messenger->requests, messenger_entry_create(player->player_data->id));
+        player_release(requested_player);
     }
-
-    cleanup:
-        free(input_search);
 }
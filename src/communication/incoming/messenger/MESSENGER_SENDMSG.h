@@ -2,6 +2,7 @@
 
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "game/player/player.h"
 #include "database/queries/messenger_query.h"
@@ -22,9 +23,10 @@ void MESSENGER_SENDMSG(session *player, incoming_message *message) {
         list_add(friends, messenger_entry_create(friend_id));
     }
 
-    char *chat_message = im_read_str(message);
+    char chat_buffer[MAX_MESSAGE_LENGTH + 1];
+    char *chat_message = chat_buffer;
 
-    if (chat_message == NULL) {
+    if (im_read_str_into(message, chat_buffer, sizeof(chat_buffer)) == -1) {
         goto cleanup;
     }
 
@@ -40,14 +42,9 @@ void MESSENGER_SENDMSG(session *player, incoming_message *message) {
         session *player_friend = player_manager_find_by_id(friend->user_id);
 
         if (player_friend != NULL) {
-            outgoing_message *response = om_create(134); // "BF"
-            //om_write_int(response, 1);
-            om_write_int(response, message_id);
-            om_write_int(response, player->player_data->id);
-            om_write_str(response, date);
-            om_write_str(response, chat_message);
-            player_send(player_friend, response);
-            om_cleanup(response);
+            messenger_message_packet response = { message_id, player->player_data->id, date, chat_message };
+            messenger_message_packet_send(player_friend, &response); // "BF"
+            player_release(player_friend);
         }
 
         messenger_entry_cleanup(friend);
@@ -55,6 +52,5 @@ void MESSENGER_SENDMSG(session *player, incoming_message *message) {
     }
 
     cleanup:
-    free(chat_message);
     list_destroy(friends);
 }
\ No newline at end of file
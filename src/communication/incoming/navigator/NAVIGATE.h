@@ -1,5 +1,6 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "game/navigator/navigator_category.h"
 #include "game/navigator/navigator_category_manager.h"
@@ -11,8 +12,14 @@
 #include "database/queries/rooms/room_query.h"
 
 void NAVIGATE(session *player, incoming_message *message) {
-    int hide_full = im_read_vl64(message);
-    int category_id = im_read_vl64(message);
+    navigate_packet packet;
+
+    if (!navigate_packet_decode(message, &packet)) {
+        return;
+    }
+
+    int hide_full = packet.hide_full;
+    int category_id = packet.category_id;
 
     room_category *parent_category = category_manager_get_by_id(category_id);
     outgoing_message *navigator = om_create(220); // "C\"
@@ -35,29 +42,36 @@ void NAVIGATE(session *player, incoming_message *message) {
         List *rooms = category_manager_get_rooms(parent_category->id);
         List *recent_rooms = NULL;
 
-        if (parent_category->category_type == PRIVATE) {
-            recent_rooms = room_query_recent_rooms(10, parent_category->id);
+        // Build the listing in our own list so the rooms we were handed can all be released
+        List *listed_rooms;
+        list_new(&listed_rooms);
 
-            // Remove full rooms if hide full
-            for (size_t i = 0; i < list_size(rooms); i++) {
-                room *instance;
-                list_get_at(rooms, i, (void *) &instance);
+        for (size_t i = 0; i < list_size(rooms); i++) {
+            room *instance;
+            list_get_at(rooms, i, (void *) &instance);
 
-                if (hide_full && (instance->room_data->visitors_now >= instance->room_data->visitors_max)) {
-                    list_remove(rooms, instance, NULL);
-                }
+            // Remove full rooms if hide full
+            if (parent_category->category_type == PRIVATE && hide_full
+                && atomic_load(&instance->room_data->visitors_now) >= instance->room_data->visitors_max) {
+                continue;
             }
 
+            list_add(listed_rooms, instance);
+        }
+
+        if (parent_category->category_type == PRIVATE) {
+            recent_rooms = room_query_recent_rooms(10, parent_category->id);
+
             // Add integer for the amount of public rooms
-            om_write_int(navigator, (int) list_size(rooms));  // rooms count
+            om_write_int(navigator, (int) list_size(listed_rooms));  // rooms count
         }
 
-        list_sort_in_place(rooms, room_manager_sort_id);
-        list_sort_in_place(rooms, room_manager_sort);
+        list_sort_in_place(listed_rooms, room_manager_sort_id);
+        list_sort_in_place(listed_rooms, room_manager_sort);
 
-        for (size_t i = 0; i < list_size(rooms); i++) {
+        for (size_t i = 0; i < list_size(listed_rooms); i++) {
             room *instance;
-            list_get_at(rooms, i, (void *) &instance);
+            list_get_at(listed_rooms, i, (void *) &instance);
             room_append_data(instance, navigator, player->player_data->id);
         }
 
@@ -84,16 +98,19 @@ void NAVIGATE(session *player, incoming_message *message) {
             for (size_t i = 0; i < list_size(recent_rooms); i++) {
                 room *instance;
                 list_get_at(recent_rooms, i, (void *) &instance);
-
-                if (room_manager_get_by_id(instance->room_id) == NULL) {
-                    room_dispose(instance, false);
-                }
+                room_release(instance);
             }
 
             list_destroy(recent_rooms);
         }
 
+        for (size_t i = 0; i < list_size(rooms); i++) {
+            room *instance;
+            list_get_at(rooms, i, (void *) &instance);
+            room_release(instance);
+        }
 
+        list_destroy(listed_rooms);
         list_destroy(rooms);
         list_destroy(child_categories);
     }
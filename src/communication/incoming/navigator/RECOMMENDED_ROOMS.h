@@ -24,16 +24,11 @@ void RECOMMENDED_ROOMS(session *player, incoming_message *message) {
     player_send(player, navigator);
     om_cleanup(navigator);
 
-    // Clear recommended rooms if they weren't already loaded
-    if (rooms != NULL) {
-        for (size_t i = 0; i < list_size(rooms); i++) {
-            room *instance;
-            list_get_at(rooms, i, (void *) &instance);
-
-            if (room_manager_get_by_id(instance->room_id) == NULL) {
-                room_dispose(instance, false);
-            }
-        }
+    // Release recommended rooms, rooms that weren't already loaded are freed
+    for (size_t i = 0; i < list_size(rooms); i++) {
+        room *instance;
+        list_get_at(rooms, i, (void *) &instance);
+        room_release(instance);
     }
 
     // Destroy list of recent rooms
@@ -1,12 +1,17 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "database/queries/rooms/room_favourites_query.h"
 
 void REMOVE_FAVOURITE_ROOM(session *player, incoming_message *message) {
-    im_read_vl64(message);
+    remove_favourite_room_packet packet;
 
-    int room_id = im_read_vl64(message);
+    if (!remove_favourite_room_packet_decode(message, &packet)) {
+        return;
+    }
+
+    int room_id = packet.room_id;
 
     if (room_query_check_favourite(room_id, player->player_data->id) == -1) {
         return;
@@ -38,7 +38,7 @@ void SRCHF(session *player, incoming_message *message) {
             }
 
             om_write_str_delimeter(om, "x", 9);
-            om_write_int_delimeter(om, room->room_data->visitors_now, 9);
+            om_write_int_delimeter(om, atomic_load(&room->room_data->visitors_now), 9);
             om_write_int_delimeter(om, room->room_data->visitors_max, 9);
             om_write_str_delimeter(om, "null", 9);
             om_write_str_delimeter(om, room->room_data->description, 9);
@@ -53,16 +53,15 @@ void SRCHF(session *player, incoming_message *message) {
     player_send(player, om);
     om_cleanup(om);
 
-    // Clear room favourites if they weren't already loaded prior in the server
+    // Release searched rooms, rooms that weren't already loaded prior in the server are freed
     for (size_t i = 0; i < list_size(searched_rooms); i++) {
         room *instance;
         list_get_at(searched_rooms, i, (void *) &instance);
-
-        if (room_manager_get_by_id(instance->room_id) == NULL) {
-            room_dispose(instance, false);
-        }
+        room_release(instance);
     }
 
+    list_destroy(searched_rooms);
+
     cleanup:
     free(content);
 }
@@ -37,7 +37,7 @@ void SUSERF(session *player, incoming_message *message) {
             }
 
             om_write_str_delimeter(om, "x", 9);
-            om_write_int_delimeter(om, room->room_data->visitors_now, 9);
+            om_write_int_delimeter(om, atomic_load(&room->room_data->visitors_now), 9);
             om_write_int_delimeter(om, room->room_data->visitors_max, 9);
             om_write_str_delimeter(om, "null", 9);
             om_write_str_delimeter(om, room->room_data->description, 9);
@@ -54,6 +54,11 @@ void SUSERF(session *player, incoming_message *message) {
         om_cleanup(om);
     }
 
+    for (size_t i = 0; i < list_size(rooms); i++) {
+        room *room;
+        list_get_at(rooms, i, (void *) &room);
+        room_release(room);
+    }
 
     list_destroy(rooms);
 }
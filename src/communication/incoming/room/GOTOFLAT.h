@@ -5,33 +5,30 @@
 #include "game/room/manager/room_entity_manager.h"
 
 void GOTOFLAT(session *player, incoming_message *message) {
-    char *content = im_get_content(message);
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
     if (!is_numeric(content)) {
-        goto cleanup;
+        return;
     }
 
     int room_id = (int)strtol(content, NULL, 10);
-    room *room = room_manager_get_by_id(room_id);
 
     if (player->room_user->authenticate_id != room_id) {
-        goto cleanup;
+        return;
     }
 
-    if (room == NULL) {
-        room = room_query_get_by_room_id(room_id);
+    room *room = room_manager_get_by_id(room_id);
 
-        if (room != NULL) {
-            hashtable_add(global.room_manager.rooms, &room->room_id, room);
-        }
+    if (room == NULL) {
+        room_manager_add(room_id);
+        room = room_manager_get_by_id(room_id);
     }
 
     if (room == NULL) {
-        goto cleanup;
+        return;
     }
 
     room_enter(room, player);
-
-    cleanup:
-        free(content);
+    room_release(room);
 }
@@ -17,12 +17,8 @@ void G_ITEMS(session *player, incoming_message *message) {
     for (size_t i = 0; i < list_size(wall_items); i++) {
         item *room_item;
         list_get_at(wall_items, i, (void*)&room_item);
-        char *item_string = item_as_string(room_item);
-
-        sb_add_string(om->sb, item_string);
+        item_append_string(room_item, om->sb);
         sb_add_char(om->sb, 13);
-
-        free(item_string);
     }
 
     player_send(player, om);
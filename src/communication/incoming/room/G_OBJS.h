@@ -22,13 +22,13 @@ void G_OBJS(session *player, incoming_message *message) {
     List *floor_items = room_item_manager_floor_items(room);
 
     outgoing_message *om = om_create(30); // "@^
+    sb_reserve(om->sb, (int) list_size(public_items) * ITEM_STRING_ESTIMATE);
+
     for (size_t i = 0; i < list_size(public_items); i++) {
         item *room_item;
         list_get_at(public_items, i, (void*)&room_item);
 
-        char *item_string = item_as_string(room_item);
-        sb_add_string(om->sb, item_string);
-        free(item_string);
+        item_append_string(room_item, om->sb);
     }
 
     player_send(player, om);
@@ -36,14 +36,13 @@ void G_OBJS(session *player, incoming_message *message) {
 
     om = om_create(32); // "@`"
     om_write_int(om, (int)list_size(floor_items));
+    sb_reserve(om->sb, (int) list_size(floor_items) * ITEM_STRING_ESTIMATE);
 
     for (size_t i = 0; i < list_size(floor_items); i++) {
         item *item;
         list_get_at(floor_items, i, (void*)&item);
 
-        char *item_string = item_as_string(item);
-        sb_add_string(om->sb, item_string);
-        free(item_string);
+        item_append_string(item, om->sb);
     }
 
     player_send(player, om);
@@ -2,30 +2,30 @@
 #include "communication/messages/outgoing_message.h"
 
 void LETUSERIN(session *user, incoming_message *message) {
-    char *content = im_get_content(message);
-    char *ringing_username = NULL;
-
-    if (content == NULL) {
-        goto cleanup;
-    }
-
     if (user->room_user->room == NULL) {
-        goto cleanup;
+        return;
     }
 
     room *room = user->room_user->room;
 
     if (!room_has_rights(room, user->player_data->id)) {
-        goto cleanup;
+        return;
     }
 
-    ringing_username = im_read_str(message);
-    bool can_enter = content[strlen(content) - 1] == 'A';
+    int length;
+    const char *content = im_get_content_view(message, &length);
+    bool can_enter = length > 0 && content[length - 1] == 'A';
+
+    char ringing_username[MAX_USERNAME_LENGTH + 1];
+
+    if (im_read_str_into(message, ringing_username, sizeof(ringing_username)) == -1) {
+        return;
+    }
 
     session *to_enter = player_manager_find_by_name(ringing_username);
 
     if (to_enter == NULL) {
-        goto cleanup;
+        return;
     }
 
     int message_id;
@@ -41,7 +41,5 @@ void LETUSERIN(session *user, incoming_message *message) {
     player_send(to_enter, om);
     om_cleanup(om);
 
-    cleanup:
-        free(content);
-        free(ringing_username);
+    player_release(to_enter);
 }
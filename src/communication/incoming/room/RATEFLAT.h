@@ -2,6 +2,7 @@
 
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "game/player/player.h"
 
@@ -10,12 +11,20 @@
 
 #include "database/queries/rooms/room_vote_query.h"
 
+#include "util/shared_buffer.h"
+
 void RATEFLAT(session *player, incoming_message *im) {
     if (player->room_user->room == NULL) {
         return;
     }
 
-    int answer = im_read_vl64(im);
+    rate_flat_packet packet;
+
+    if (!rate_flat_packet_decode(im, &packet)) {
+        return;
+    }
+
+    int answer = packet.answer;
 
     if (answer != 1 && answer != -1) {
         return;
@@ -32,12 +41,9 @@ void RATEFLAT(session *player, incoming_message *im) {
 
     room_query_vote(room_id, player_id, answer);
 
-    int votes = room_query_count_votes(room_id);
-
-    outgoing_message *om = om_create(345); // "EY"
-    om_write_int(om, votes);
-    player_send(player, om);
-    om_cleanup(om);
+    vote_count_packet vote_count = { room_query_count_votes(room_id) };
+    shared_buffer *votes = vote_count_packet_build(&vote_count); // "EY"
+    player_send_buffer(player, votes);
 
     room *room = player->room_user->room;
 
@@ -54,11 +60,10 @@ void RATEFLAT(session *player, incoming_message *im) {
             continue;
         }
 
-        om = om_create(345); // "EY"
-        om_write_int(om, votes);
-        player_send(room_player, om);
-        om_cleanup(om);
+        player_send_buffer(room_player, votes);
     }
 
+    shared_buffer_release(votes);
+
     // TODO: loop through all rooms users and send new vote count to users who haven't voted yet
 }
@@ -30,11 +30,9 @@ void TRYFLAT(session *player, incoming_message *message) {
     }
 
     room *room = room_manager_get_by_id(room_id);
-    bool dispose_after = false;
 
     if (room == NULL) {
         room = room_query_get_by_room_id(room_id);
-        dispose_after = true;
     }
 
     if (room == NULL) {
@@ -52,31 +50,26 @@ void TRYFLAT(session *player, incoming_message *message) {
         outgoing_message *om = om_create(message_id);
         player_send(player, om);
         om_cleanup(om);
-        return;
+        goto release;
     }
 
     // Password checking
     if (room->room_data->accesstype == 2 && room_is_owner(room, player->player_data->id)) { // TODO: Fuseright checks
         if (password == NULL || strcmp(password, room->room_data->password) != 0) {
             send_localised_error(player, "Incorrect flat password");
-            return;
+            goto release;
         }
     }
 
-    // Leave other room
-    if (player->room_user->room != NULL) {
-        room_leave(player->room_user->room, player, false);
-    }
-
+    // The previous room was already left when the session was routed to this room
     player->room_user->authenticate_id = room_id;
 
     outgoing_message *interest = om_create(41); // "@i"
     player_send(player, interest);
     om_cleanup(interest);
 
-    if (dispose_after) {
-        room_dispose(room, false);
-    }
+    release:
+        room_release(room);
 
     cleanup:
         free(content);
@@ -19,22 +19,19 @@ void ADDSTRIPITEM(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
-    if (content == NULL) {
-        return;
-    }
-
-    char *remove_data_item_id = get_argument(content, " ", 2);
+    int item_id;
 
-    if (remove_data_item_id == NULL) {
-        goto cleanup;
+    if (sscanf(content, "%*s %*s %d", &item_id) != 1) {
+        return;
     }
 
-    item *item = room_item_manager_get(player->room_user->room, (int)strtol(remove_data_item_id, NULL, 10));
+    item *item = room_item_manager_get(player->room_user->room, item_id);
 
     if (item == NULL || item->definition->behaviour->is_post_it) {
-        goto cleanup;
+        return;
     }
 
     room_map_remove_item(player->room_user->room, item);
@@ -42,8 +39,4 @@ void ADDSTRIPITEM(session *player, incoming_message *message) {
     inventory *inv = (inventory *) player->inventory;
     list_add(inv->items, item);
     inventory_send(inv, "update", player);
-
-    cleanup:
-        free(content);
-        free(remove_data_item_id);
 }
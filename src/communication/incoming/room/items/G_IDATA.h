@@ -14,16 +14,17 @@ void G_IDATA(session *player, incoming_message *message) {
         return;
     }
 
-    char *str_item_id = im_get_content(message);
+    int length;
+    const char *str_item_id = im_get_content_view(message, &length);
 
-    if (str_item_id == NULL || !is_numeric(str_item_id)) {
-        goto cleanup;
+    if (!is_numeric(str_item_id)) {
+        return;
     }
 
     item *item = room_item_manager_get(player->room_user->room, (int) strtol(str_item_id, NULL, 10));
 
     if (item == NULL || !item->definition->behaviour->is_post_it) {
-        goto cleanup;
+        return;
     }
 
     char color[7];
@@ -31,7 +32,7 @@ void G_IDATA(session *player, incoming_message *message) {
     color[6] = '\0';
 
     outgoing_message *om = om_create(48); // "@p"
-    om_write_str_delimeter(om, str_item_id, 9);
+    om_write_int_delimeter(om, item->id, 9);
     sb_add_string(om->sb, color);
     sb_add_string(om->sb, " ");
 
@@ -42,7 +43,4 @@ void G_IDATA(session *player, incoming_message *message) {
 
     player_send(player, om);
     om_cleanup(om);
-
-    cleanup:
-    free(str_item_id);
 }
\ No newline at end of file
@@ -21,37 +21,23 @@ void MOVESTUFF(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
-    if (content == NULL) {
-        return;
-    }
+    int item_id, x, y, rotation;
 
-    char *str_id = get_argument(content, " ", 0);
-    char *str_x = NULL;
-    char *str_y = NULL;
-    char *str_rot = NULL;
-
-    if (str_id == NULL) {
-        goto cleanup;
+    if (sscanf(content, "%d %d %d %d", &item_id, &x, &y, &rotation) != 4) {
+        return;
     }
 
-    item *item = room_item_manager_get(player->room_user->room, (int)strtol(str_id, NULL, 10));
+    item *item = room_item_manager_get(player->room_user->room, item_id);
 
     if (item == NULL) {
-        goto cleanup;
+        return;
     }
 
     if (item->definition->behaviour->is_wall_item) {
-        goto cleanup;
-    }
-
-    str_x = get_argument(content, " ", 1);
-    str_y = get_argument(content, " ", 2);
-    str_rot = get_argument(content, " ", 3);
-
-    if (str_x == NULL || str_y == NULL || str_rot == NULL) {
-        goto cleanup;
+        return;
     }
 
     coord old_position;
@@ -59,28 +45,13 @@ void MOVESTUFF(session *player, incoming_message *message) {
     old_position.y = item->position->y;
     old_position.rotation = item->position->rotation;
 
-    if (old_position.x == (int) strtol(str_x, NULL, 10) &&
-        old_position.y == (int) strtol(str_y, NULL, 10) &&
-        old_position.rotation == (int) strtol(str_rot, NULL, 10)) {
-        goto cleanup; // Do absolutely nothing because the item technically didn't move at all
-    }
-
-    item->position->x = (int) strtol(str_x, NULL, 10);
-    item->position->y = (int) strtol(str_y, NULL, 10);
-    item->position->rotation = (int) strtol(str_rot, NULL, 10);
-
-    bool rotation = false;
-
-    if (item->position->rotation != old_position.rotation) {
-        rotation = true;
+    if (old_position.x == x && old_position.y == y && old_position.rotation == rotation) {
+        return; // Do absolutely nothing because the item technically didn't move at all
     }
 
-    room_map_move_item(player->room_user->room, item, rotation, &old_position);
+    item->position->x = x;
+    item->position->y = y;
+    item->position->rotation = rotation;
 
-    cleanup:
-        free(content);
-		free(str_id);
-		free(str_x);
-		free(str_rot);
-		free(str_y);
+    room_map_move_item(player->room_user->room, item, rotation != old_position.rotation, &old_position);
 }
@@ -19,34 +19,34 @@ void PLACESTUFF(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
-
-    if (content == NULL) {
-        return;
-    }
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
     inventory *inv = (inventory *) player->inventory;
 
-    char *str_id = get_argument(content, " ", 0);
+    int item_id;
 
-    char *str_x = NULL;
-    char *str_y = NULL;
-
-    if (str_id == NULL) {
-        goto cleanup;
+    if (sscanf(content, "%d", &item_id) != 1) {
+        return;
     }
 
-    item *place_item = inventory_get_item(inv, (int)strtol(str_id, NULL, 10));
+    item *place_item = inventory_get_item(inv, item_id);
 
     if (place_item == NULL) {
-        goto cleanup;
+        return;
     }
 
     if (place_item->definition->behaviour->is_wall_item) {
-        char id_as_string[10];
+        char id_as_string[12];
         sprintf(id_as_string, "%i", place_item->id);
 
-        char *wall_position = strdup(content + strlen(id_as_string) + 1);
+        size_t wall_offset = strlen(id_as_string) + 1;
+
+        if (wall_offset > (size_t) length) {
+            return;
+        }
+
+        char *wall_position = strdup(content + wall_offset);
 
         if (place_item->definition->behaviour->is_post_it) {
             // Create postit in database
@@ -76,31 +76,23 @@ void PLACESTUFF(session *player, incoming_message *message) {
                 }
             }
 
-            goto cleanup;
+            return;
         }
 
         place_item->wall_position = wall_position;
 
     } else {
-        str_x = get_argument(content, " ", 1);
-        str_y = get_argument(content, " ", 2);
+        int x, y;
 
-        if (str_x == NULL || str_y == NULL) {
-            goto cleanup;
+        if (sscanf(content, "%*d %d %d", &x, &y) != 2) {
+            return;
         }
 
-        place_item->position->x = (int) strtol(str_x, NULL, 10);
-        place_item->position->y = (int) strtol(str_y, NULL, 10);
+        place_item->position->x = x;
+        place_item->position->y = y;
         place_item->position->rotation = 0;
     }
 
     room_map_add_item(player->room_user->room, place_item);
     list_remove(inv->items, place_item, NULL);
-
-    cleanup:
-        free(content);
-		free(str_id);
-		free(str_x);
-		free(str_y);
-        
 }
@@ -18,26 +18,19 @@ void REMOVESTUFF(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
-
-    if (content == NULL) {
-        return;
-    }
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
     int item_id = (int) strtol(content, NULL, 10);
 
     item *item = room_item_manager_get(player->room_user->room, item_id);
 
     if (item == NULL) {
-        goto cleanup;
+        return;
     }
 
     room_map_remove_item(player->room_user->room, item);
 
     item_query_delete(item_id);
     item_dispose(item);
-
-    cleanup:
-        free(content);
-        
 }
@@ -20,23 +20,25 @@ void SETSTUFFDATA(session *player, incoming_message *message) {
         return;
     }
 
-    char *str_item_id = im_read_str(message);
-    char *str_data = im_read_str(message);
+    // Item ids and states are short, longer values are truncated and never match a state
+    char str_item_id[12];
+    char str_data[12];
 
-    if (str_item_id == NULL || str_data == NULL) {
-        goto cleanup;
+    if (im_read_str_into(message, str_item_id, sizeof(str_item_id)) == -1
+        || im_read_str_into(message, str_data, sizeof(str_data)) == -1) {
+        return;
     }
 
     int item_id = (int) strtol(str_item_id, NULL, 10);
     item *item = room_item_manager_get(player->room_user->room, item_id);
 
     if (item == NULL || !item_contains_custom_data(item->definition)) {
-        goto cleanup;
+        return;
     }
 
     if (item->definition->behaviour->requires_rights_for_interaction &&
         !room_has_rights(player->room_user->room, player->player_data->id)) {
-        goto cleanup;
+        return;
     }
 
     char *new_data = NULL;
@@ -68,8 +70,4 @@ void SETSTUFFDATA(session *player, incoming_message *message) {
             item_query_save(item);
         }
     }
-
-    cleanup:
-    free(str_item_id);
-    free(str_data);
 }
\ No newline at end of file
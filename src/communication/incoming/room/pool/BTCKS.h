@@ -53,6 +53,7 @@ void BTCKS(session *player, incoming_message *message) {
 
         ticket_receiver->player_data->tickets = data->tickets;
         session_send_tickets(ticket_receiver);
+        player_release(ticket_receiver);
     }
 
     player->player_data->credits -= cost_credits;
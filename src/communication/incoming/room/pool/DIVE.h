@@ -5,20 +5,17 @@
 #include "game/room/pool/pool_handler.h"
 
 void DIVE(session *player, incoming_message *message) {
-    char *diving_combination = im_get_content(message);
-
-    if (diving_combination == NULL) {
-        return;
-    }
-
     if (player->room_user->room == NULL) {
-        goto cleanup;
+        return;
     }
 
     if (!player->room_user->is_diving) {
-        goto cleanup;
+        return;
     }
 
+    int length;
+    const char *diving_combination = im_get_content_view(message, &length);
+
     // Send diving packet to everybody
     outgoing_message *refresh = om_create(74); // "AJ"
     sb_add_int(refresh->sb, player->room_user->instance_id);
@@ -26,7 +23,4 @@ void DIVE(session *player, incoming_message *message) {
     sb_add_string(refresh->sb, diving_combination);
     room_send(player->room_user->room, refresh);
     om_cleanup(refresh);
-
-    cleanup:
-        free(diving_combination);
 }
@@ -6,29 +6,26 @@
 
 void SIGN(session *player, incoming_message *message) {
     if (player->room_user->room == NULL) {
-        goto cleanup;
-    }
-
-    char *vote = im_get_content(message);
-
-    if (vote == NULL) {
         return;
     }
 
+    int length;
+    const char *vote = im_get_content_view(message, &length);
+
     room_user *room_entity = (room_user *) player->room_user;
 
     if (room_entity->room == NULL) {
-        goto cleanup;
+        return;
     }
 
     if (!is_numeric(vote)) {
-        goto cleanup;
+        return;
     }
 
     int voting_id = (int) strtol(vote, NULL, 10);
 
     if (voting_id < 0) {
-        goto cleanup;
+        return;
     }
 
     if (voting_id <= 7) { // Lido voting
@@ -42,7 +39,4 @@ void SIGN(session *player, incoming_message *message) {
     room_user_reset_idle_timer(player->room_user);
 
     room_entity->needs_update = true;
-
-    cleanup:
-        free(vote);
 }
@@ -11,36 +11,22 @@
 
 void SPLASHPOSITION(session *player, incoming_message *message) {
     if (player->room_user->room == NULL) {
-        goto cleanup;
-    }
-
-    if (!player->room_user->is_diving) {
         return;
     }
 
-    char *content = im_get_content(message);
-
-    if (content == NULL) {
+    if (!player->room_user->is_diving) {
         return;
     }
 
-    if (strstr(content, ",") == NULL) {
-        goto cleanup;
-    }
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
-    char *content_x = get_argument(content, ",", 0);
-    char *content_y = get_argument(content, ",", 1);
+    coord walk_destination = {};
 
-    if (!is_numeric(content_x) || !is_numeric(content_y)) {
-        free(content_x);
-        free(content_y);
-        goto cleanup;
+    if (sscanf(content, "%d,%d", &walk_destination.x, &walk_destination.y) != 2) {
+        return;
     }
 
-    coord walk_destination = {};
-    walk_destination.x = (int) strtol(content_x, NULL, 10);
-    walk_destination.y = (int) strtol(content_y, NULL, 10);
-
     room_user *room_entity = player->room_user;
     room_user_reset_idle_timer(room_entity);
 
@@ -124,10 +110,4 @@ void SPLASHPOSITION(session *player, incoming_message *message) {
             room_player->room_user->lido_vote = -1;
         }
     }
-
-    free(content_x);
-    free(content_y);
-
-    cleanup:
-        free(content);
 }
@@ -7,7 +7,6 @@ void delete_room_items(List *items);
 
 void DELETEFLAT(session *player, incoming_message *message) {
     char *content = im_get_content(message);
-    bool dispose_after = false;
 
     if (!is_numeric(content)) {
         goto cleanup;
@@ -17,7 +16,6 @@ void DELETEFLAT(session *player, incoming_message *message) {
     room *room = room_manager_get_by_id(room_id);
 
     if (room == NULL) {
-        dispose_after = true;
         room = room_query_get_by_room_id(room_id);
     }
 
@@ -38,6 +36,8 @@ void DELETEFLAT(session *player, incoming_message *message) {
         room_query_delete(room_id);
     }
 
+    room_release(room);
+
     cleanup:
     free(content);
 }
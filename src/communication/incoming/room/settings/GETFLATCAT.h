@@ -1,17 +1,22 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 void GETFLATCAT(session *player, incoming_message *message) {
-    int room_id = im_read_vl64(message);
-    room *room = room_manager_get_by_id(room_id);
+    get_flat_category_packet packet;
+
+    if (!get_flat_category_packet_decode(message, &packet)) {
+        return;
+    }
+
+    room *room = room_manager_get_by_id(packet.room_id);
 
     if (room == NULL) {
         return;
     }
 
-    outgoing_message *om = om_create(222); // "C^"
-    om_write_int(om, room->room_id);
-    om_write_int(om, room->room_data->category);
-    player_send(player, om);
-    om_cleanup(om);
+    flat_category_packet response = { room->room_id, room->room_data->category };
+    flat_category_packet_send(player, &response); // "C^"
+
+    room_release(room);
 }
\ No newline at end of file
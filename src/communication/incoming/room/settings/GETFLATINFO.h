@@ -5,7 +5,6 @@
 
 void GETFLATINFO(session *player, incoming_message *message) {
     char *content = im_get_content(message);
-    bool dispose_after = false;
 
     if (!is_numeric(content)) {
         goto cleanup;
@@ -15,7 +14,6 @@ void GETFLATINFO(session *player, incoming_message *message) {
     room *room = room_manager_get_by_id(room_id);
 
     if (room == NULL) {
-        dispose_after = true;
         room = room_query_get_by_room_id(room_id);
     }
 
@@ -39,14 +37,12 @@ void GETFLATINFO(session *player, incoming_message *message) {
     om_write_str(flat_info, room->room_data->description);
     om_write_int(flat_info, room->room_data->show_name);
     om_write_int(flat_info, 1); // has trading
-    om_write_int(flat_info, room->room_data->visitors_now); 
+    om_write_int(flat_info, atomic_load(&room->room_data->visitors_now));
     om_write_int(flat_info, room->room_data->visitors_max);
     player_send(player, flat_info);
     om_cleanup(flat_info);
 
-    if (dispose_after) {
-        room_dispose(room, false);
-    }
+    room_release(room);
 
     cleanup:
     free(content);
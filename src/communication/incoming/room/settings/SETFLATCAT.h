@@ -21,12 +21,10 @@ void SETFLATCAT(session *player, incoming_message *message) {
         return;
     }
 
-    if (!room_is_owner(room, player->player_data->id)) {
-        return;
-    }
-
-    if (player->player_data->rank >= category->minrole_setflatcat) {
+    if (room_is_owner(room, player->player_data->id) && player->player_data->rank >= category->minrole_setflatcat) {
         room->room_data->category = category_id;
         query_room_save(room);
     }
+
+    room_release(room);
 }
\ No newline at end of file
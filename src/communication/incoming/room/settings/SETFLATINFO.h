@@ -9,6 +9,7 @@
 void SETFLATINFO(session *player, incoming_message *message) {
     char *content = im_get_content(message);
     char *argument = get_argument(content, "/", 0);
+    char *copy = NULL;
 
     if (!is_numeric(argument)) {
         goto cleanup;
@@ -22,12 +23,12 @@ void SETFLATINFO(session *player, incoming_message *message) {
     }
 
     if (!room_is_owner(room, player->player_data->id)) {
-        goto cleanup;
+        goto release;
     }
 
     int split_count = 0;
 
-    char *copy = strdup(content);
+    copy = strdup(content);
     char *token;
 
     for (token = strtok(copy, "\r"); token; token = strtok(NULL, "\r")) {
@@ -77,6 +78,9 @@ void SETFLATINFO(session *player, incoming_message *message) {
 
     query_room_save(room);
 
+    release:
+        room_release(room);
+
     cleanup:
         free(argument);
         free(copy);
@@ -21,7 +21,7 @@ void UPDATEFLAT(session *player, incoming_message *message) {
     }
 
     if (!room_is_owner(room, player->player_data->id)) {
-        goto cleanup;
+        goto release;
     }
 
     room->room_data->name = strdup(str_name);
@@ -39,6 +39,9 @@ void UPDATEFLAT(session *player, incoming_message *message) {
 
     query_room_save(room);
 
+    release:
+        room_release(room);
+
     cleanup:
         free(str_id);
         free(content);
@@ -30,7 +30,13 @@ void ASSIGNRIGHTS(session *player, incoming_message *im) {
         rights_entry *entry = rights_entry_create(user_id);
         list_add(room->rights, entry);
 
-        room_refresh_rights(room, player_manager_find_by_id(user_id));
+        session *to_assign = player_manager_find_by_id(user_id);
+
+        if (to_assign != NULL) {
+            room_refresh_rights(room, to_assign);
+            player_release(to_assign);
+        }
+
         room_query_add_rights(room->room_id, user_id);
     }
 
@@ -9,11 +9,8 @@ void CARRYDRINK(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
-
-    if (content == NULL) {
-        return;
-    }
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
     if (is_numeric(content)) {
         int drink_id = (int) strtol(content, NULL, 10);
@@ -14,9 +14,10 @@ void CHAT(session *player, incoming_message *im) {
         return;
     }
 
-    char *message = im_read_str(im);
+    char message_buffer[MAX_MESSAGE_LENGTH + 1];
+    char *message = message_buffer;
 
-    if (message != NULL) {
+    if (im_read_str_into(im, message_buffer, sizeof(message_buffer)) != -1) {
         filter_vulnerable_characters(&message, true);
 
         // Process command
@@ -32,7 +33,7 @@ void CHAT(session *player, incoming_message *im) {
                 player->room_user->is_typing = false;
             }
 
-            goto cleanup;
+            return;
         }
 
         room_user_reset_idle_timer(player->room_user);
@@ -87,7 +88,4 @@ void CHAT(session *player, incoming_message *im) {
             }
         }
     }
-
-    cleanup:
-        free(message);
 }
@@ -12,24 +12,24 @@ void LOOKTO(session *player, incoming_message *message) {
         return;
     }
 
-    char *content = im_get_content(message);
-    char *str_x = NULL;
-    char *str_y = NULL;
+    int length;
+    const char *content = im_get_content_view(message, &length);
 
-    str_x = get_argument(content, " ", 0);
-    str_y = get_argument(content, " ", 1);
+    // The content is "x y", the frame is zero terminated so it can be parsed in place
+    char *end_x = NULL;
+    char *end_y = NULL;
 
-    if (str_x == NULL || str_y == NULL || content == NULL) {
-        goto cleanup;
-    }
+    int towards_x = (int) strtol(content, &end_x, 10);
+    int towards_y = (int) strtol(end_x, &end_y, 10);
 
-    int towards_x = (int) strtol(str_x, NULL, 10);
-    int towards_y = (int) strtol(str_y, NULL, 10);
+    if (end_x == content || end_y == end_x) {
+        return;
+    }
 
     room_user *room_entity = player->room_user;
 
     if (room_user_has_status(room_entity, "sit") || room_user_has_status(room_entity, "lay")) {
-        goto cleanup;
+        return;
     }
 
     int rotation = calculate_human_direction(room_entity->position->x, room_entity->position->y, towards_x, towards_y);
@@ -37,10 +37,4 @@ void LOOKTO(session *player, incoming_message *message) {
 
     room_entity->needs_update = true;
     room_user_reset_idle_timer(player->room_user);
-
-    cleanup:
-    free(content);
-    free(str_x);
-    free(str_y);
-        
 }
@@ -34,13 +34,17 @@ void REMOVERIGHTS(session *player, incoming_message *im) {
 
         session *to_remove = player_manager_find_by_id(user_id);
 
-        if (to_remove->room_user->room_id == room->room_id) {
-            room_user_remove_status(to_remove->room_user, "flatctrl");
-            to_remove->room_user->needs_update = true;
+        if (to_remove != NULL) {
+            if (to_remove->room_user->room_id == room->room_id) {
+                room_user_remove_status(to_remove->room_user, "flatctrl");
+                to_remove->room_user->needs_update = true;
 
-            outgoing_message *om = om_create(43); // "@k"
-            player_send(to_remove, om);
-            om_cleanup(om);
+                outgoing_message *om = om_create(43); // "@k"
+                player_send(to_remove, om);
+                om_cleanup(om);
+            }
+
+            player_release(to_remove);
         }
 
         room_query_remove_rights(room->room_id, user_id);
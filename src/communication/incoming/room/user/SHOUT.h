@@ -13,9 +13,10 @@ void SHOUT(session *player, incoming_message *im) {
         return;
     }
 
-    char *message = im_read_str(im);
+    char message_buffer[MAX_MESSAGE_LENGTH + 1];
+    char *message = message_buffer;
 
-    if (message != NULL) {
+    if (im_read_str_into(im, message_buffer, sizeof(message_buffer)) != -1) {
         filter_vulnerable_characters(&message, true);
 
         // Process command
@@ -31,7 +32,7 @@ void SHOUT(session *player, incoming_message *im) {
                 player->room_user->is_typing = false;
             }
 
-            goto cleanup;
+            return;
         }
 
         room_user_show_chat((room_user *) player->room_user, message, true);
@@ -43,7 +44,4 @@ void SHOUT(session *player, incoming_message *im) {
         room_send(player->room_user->room, om);
         om_cleanup(om);
     }
-
-    cleanup:
-        free(message);
 }
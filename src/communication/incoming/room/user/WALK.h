@@ -1,5 +1,6 @@
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_schema.h"
 
 #include "game/player/player.h"
 
@@ -15,9 +16,12 @@ void WALK(session *player, incoming_message *im) {
         return;
     }
 
-    int x = im_read_b64_int(im);
-    int y = im_read_b64_int(im);
-    
-    walk_to((room_user*) player->room_user, x, y);
+    walk_packet packet;
+
+    if (!walk_packet_decode(im, &packet)) {
+        return;
+    }
+
+    walk_to((room_user*) player->room_user, packet.x, packet.y);
     room_user_reset_idle_timer(player->room_user);
 }
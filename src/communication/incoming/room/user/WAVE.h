@@ -5,8 +5,6 @@
 
 #include "game/room/room.h"
 
-#include "thpool.h"
-
 void WAVE(session *player, incoming_message *im) {
     if (player->room_user->room == NULL) {
         return;
@@ -18,8 +16,4 @@ void WAVE(session *player, incoming_message *im) {
     }
 
     room_user_reset_idle_timer(player->room_user);
-
-    /*if (!room_user_has_status(session->room_user, "wave")) {
-        thpool_add_work(global.thread_manager.pool, (void*)wave_task, session->room_user);
-    }*/
 }
@@ -1,9 +1,18 @@
 #include "communication/messages/incoming_message.h"
 
 #include "message_handler.h"
+#include "message_stats.h"
 #include <shared.h>
 
 #include "game/player/player.h"
+#include "game/room/room.h"
+#include "game/room/room_user.h"
+#include "game/room/room_manager.h"
+#include "game/room/manager/room_entity_manager.h"
+
+#include "util/actor.h"
+#include "util/scheduler.h"
+#include "util/encoding/vl64encoding.h"
 
 // Login
 #include "communication/incoming/login/INIT_CRYPTO.h"
@@ -120,169 +129,461 @@
 // Trax
 #include "communication/incoming/room/trax/GET_SONG_LIST.h"
 
+message_entry message_table[MESSAGES];
+
 // Only allow these headers to be processed if the session is not logged in.
-int packet_whitelist[] = { 206, 202, 4, 49, 42, 203, 197, 146, 46, 43, 204, 196 };
+static const int packet_whitelist[] = { 206, 202, 4, 49, 42, 203, 197, 146, 46, 43, 204, 196 };
+
+// How many messages of each rate class a session may send, loading a room alone is about ten messages
+static const message_rate_limit rate_limits[MESSAGE_RATE_CLASSES] = {
+    [MESSAGE_RATE_DEFAULT] = { 60, 30 },
+    [MESSAGE_RATE_WALK] = { 10, 5 },
+    [MESSAGE_RATE_CHAT] = { 8, 2 },
+    [MESSAGE_RATE_ROOM_ENTRY] = { 10, 2 },
+    [MESSAGE_RATE_ITEM] = { 20, 10 }
+};
 
 /**
- * Assigns all header handlers to this array
+ * Assigns all header handlers to the dispatch table
  */
 void message_handler_init() {
     // Login
-    message_requests[206] = INIT_CRYPTO;
-    message_requests[202] = GENERATEKEY;
-    message_requests[4] = TRY_LOGIN;
-    message_requests[49] = GDATE;
-    message_requests[196] = PONG;
+    message_handler_add(206, INIT_CRYPTO, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(202, GENERATEKEY, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(4, TRY_LOGIN, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(49, GDATE, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(196, PONG, MESSAGE_ROUTE_LOOP);
 
     if (configuration_get_bool("sso.tickets.enabled")) {
-        message_requests[204] = SSO;
+        message_handler_add(204, SSO, MESSAGE_ROUTE_HOTEL);
     }
 
     // Register
-    message_requests[42] = APPROVENAME;
-    message_requests[203] = APPROVE_PASSWORD;
-    message_requests[197] = APPROVEEMAIL;
-    message_requests[146] = PARENT_EMAIL_REQUIRED;
-    message_requests[46] = CHECK_AGE;
-    message_requests[43] = REGISTER;
+    message_handler_add(42, APPROVENAME, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(203, APPROVE_PASSWORD, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(197, APPROVEEMAIL, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(146, PARENT_EMAIL_REQUIRED, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(46, CHECK_AGE, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(43, REGISTER, MESSAGE_ROUTE_HOTEL);
 
     // User
-    message_requests[7] = GET_INFO;
-    message_requests[8] = GET_CREDITS;
-    message_requests[44] = UPDATE;
-    message_requests[149] = UPDATE_ACCOUNT;
+    message_handler_add(7, GET_INFO, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(8, GET_CREDITS, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(44, UPDATE, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(149, UPDATE_ACCOUNT, MESSAGE_ROUTE_HOTEL);
 
     // Club
-    message_requests[26] = GET_CLUB;
-    message_requests[190] = SUBSCRIBE_CLUB;
+    message_handler_add(26, GET_CLUB, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(190, SUBSCRIBE_CLUB, MESSAGE_ROUTE_HOTEL);
 
     // Messenger
-    message_requests[12] = MESSENGERINIT;
-    message_requests[41] = FINDUSER;
-    message_requests[40] = MESSENGER_REMOVEBUDDY;
-    message_requests[36] = MESSENGER_ASSIGNPERSMSG;
-    message_requests[39] = MESSENGER_REQUESTBUDDY;
-    message_requests[38] = MESSENGER_DECLINEBUDDY;
-    message_requests[37] = MESSENGER_ACCEPTBUDDY;
-    message_requests[233] = MESSENGER_GETREQUESTS;
-    message_requests[33] = MESSENGER_SENDMSG;
-    message_requests[191] = MESSENGER_GETMESSAGES;
-    message_requests[32] = MESSENGER_MARKREAD;
+    message_handler_add(12, MESSENGERINIT, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(41, FINDUSER, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(40, MESSENGER_REMOVEBUDDY, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(36, MESSENGER_ASSIGNPERSMSG, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(39, MESSENGER_REQUESTBUDDY, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(38, MESSENGER_DECLINEBUDDY, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(37, MESSENGER_ACCEPTBUDDY, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(233, MESSENGER_GETREQUESTS, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(33, MESSENGER_SENDMSG, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(191, MESSENGER_GETMESSAGES, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(32, MESSENGER_MARKREAD, MESSAGE_ROUTE_HOTEL);
 
     // Navigator
-    message_requests[150] = NAVIGATE;
-    message_requests[16] = SUSERF;
-    message_requests[151] = GETUSERFLATCATS;
-    message_requests[264] = RECOMMENDED_ROOMS;
-    message_requests[19] = ADD_FAVOURITE_ROOM;
-    message_requests[20] = REMOVE_FAVOURITE_ROOM;
-    message_requests[18] = GETFVRF;
-    message_requests[17] = SRCHF;
+    message_handler_add(150, NAVIGATE, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(16, SUSERF, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(151, GETUSERFLATCATS, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(264, RECOMMENDED_ROOMS, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(19, ADD_FAVOURITE_ROOM, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(20, REMOVE_FAVOURITE_ROOM, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(18, GETFVRF, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(17, SRCHF, MESSAGE_ROUTE_HOTEL);
 
     // Room
-    message_requests[182] = GETINTERST;
-    message_requests[2] = room_directory;
-    message_requests[57] = TRYFLAT; // @y1052/123
-    message_requests[59] = GOTOFLAT;
-    message_requests[126] = GETROOMAD;
-    message_requests[60] = G_HMAP;
-    message_requests[62] = G_OBJS;
-    message_requests[64] = G_STAT;
-    message_requests[63] = G_ITEMS;
-    message_requests[61] = G_USRS;
-    message_requests[213] = GET_FURNI_REVISIONS;
-    message_requests[98] = LETUSERIN;
-    message_requests[261] = RATEFLAT;
+    message_handler_add(182, GETINTERST, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(2, room_directory, MESSAGE_ROUTE_ROOM_ENTRY);
+    message_handler_add(57, TRYFLAT, MESSAGE_ROUTE_ROOM_ENTRY); // @y1052/123
+    message_handler_add(59, GOTOFLAT, MESSAGE_ROUTE_ROOM_ENTRY);
+    message_handler_add(126, GETROOMAD, MESSAGE_ROUTE_ROOM);
+    message_handler_add(60, G_HMAP, MESSAGE_ROUTE_ROOM);
+    message_handler_add(62, G_OBJS, MESSAGE_ROUTE_ROOM);
+    message_handler_add(64, G_STAT, MESSAGE_ROUTE_ROOM);
+    message_handler_add(63, G_ITEMS, MESSAGE_ROUTE_ROOM);
+    message_handler_add(61, G_USRS, MESSAGE_ROUTE_ROOM);
+    message_handler_add(213, GET_FURNI_REVISIONS, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(98, LETUSERIN, MESSAGE_ROUTE_ROOM);
+    message_handler_add(261, RATEFLAT, MESSAGE_ROUTE_ROOM);
 
     // Pool
-    message_requests[116] = SWIMSUIT;
-    message_requests[106] = DIVE;
-    message_requests[107] = SPLASHPOSITION;
-    message_requests[104] = SIGN;
-    message_requests[105] = BTCKS;
+    message_handler_add(116, SWIMSUIT, MESSAGE_ROUTE_ROOM);
+    message_handler_add(106, DIVE, MESSAGE_ROUTE_ROOM);
+    message_handler_add(107, SPLASHPOSITION, MESSAGE_ROUTE_ROOM);
+    message_handler_add(104, SIGN, MESSAGE_ROUTE_ROOM);
+    message_handler_add(105, BTCKS, MESSAGE_ROUTE_ROOM);
 
     // Room user
-    message_requests[53] = QUIT;
-    message_requests[75] = WALK;
-    message_requests[52] = CHAT;
-    message_requests[55] = SHOUT;
-    message_requests[94] = WAVE;
-    message_requests[79] = LOOKTO;
-    message_requests[80] = CARRYDRINK;
-    message_requests[317] = USER_START_TYPING;
-    message_requests[318] = USER_CANCEL_TYPING;
-    message_requests[96] = ASSIGNRIGHTS;
-    message_requests[97] = REMOVERIGHTS;
+    message_handler_add(53, QUIT, MESSAGE_ROUTE_ROOM_EXIT);
+    message_handler_add(75, WALK, MESSAGE_ROUTE_ROOM);
+    message_handler_add(52, CHAT, MESSAGE_ROUTE_ROOM);
+    message_handler_add(55, SHOUT, MESSAGE_ROUTE_ROOM);
+    message_handler_add(94, WAVE, MESSAGE_ROUTE_ROOM);
+    message_handler_add(79, LOOKTO, MESSAGE_ROUTE_ROOM);
+    message_handler_add(80, CARRYDRINK, MESSAGE_ROUTE_ROOM);
+    message_handler_add(317, USER_START_TYPING, MESSAGE_ROUTE_ROOM);
+    message_handler_add(318, USER_CANCEL_TYPING, MESSAGE_ROUTE_ROOM);
+    message_handler_add(96, ASSIGNRIGHTS, MESSAGE_ROUTE_ROOM);
+    message_handler_add(97, REMOVERIGHTS, MESSAGE_ROUTE_ROOM);
 
     // Room settings
-    message_requests[21] = GETFLATINFO;
-    message_requests[29] = CREATEFLAT;
-    message_requests[25] = SETFLATINFO;
-    message_requests[24] = UPDATEFLAT;
-    message_requests[152] = GETFLATCAT;
-    message_requests[153] = SETFLATCAT;
-    message_requests[23] = DELETEFLAT;
+    message_handler_add(21, GETFLATINFO, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(29, CREATEFLAT, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(25, SETFLATINFO, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(24, UPDATEFLAT, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(152, GETFLATCAT, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(153, SETFLATCAT, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(23, DELETEFLAT, MESSAGE_ROUTE_ROOM_TARGET);
 
     // Room items
-    message_requests[90] = PLACESTUFF;
-    message_requests[73] = MOVESTUFF;
-    message_requests[67] = ADDSTRIPITEM;
-    message_requests[99] = REMOVESTUFF;
-    message_requests[85] = REMOVEITEM;
-    message_requests[74] = SETSTUFFDATA;
-    message_requests[183] = CONVERT_FURNI_TO_CREDITS;
-    message_requests[83] = G_IDATA;
-    message_requests[84] = SETITEMDATA;
+    message_handler_add(90, PLACESTUFF, MESSAGE_ROUTE_ROOM);
+    message_handler_add(73, MOVESTUFF, MESSAGE_ROUTE_ROOM);
+    message_handler_add(67, ADDSTRIPITEM, MESSAGE_ROUTE_ROOM);
+    message_handler_add(99, REMOVESTUFF, MESSAGE_ROUTE_ROOM);
+    message_handler_add(85, REMOVEITEM, MESSAGE_ROUTE_ROOM);
+    message_handler_add(74, SETSTUFFDATA, MESSAGE_ROUTE_ROOM);
+    message_handler_add(183, CONVERT_FURNI_TO_CREDITS, MESSAGE_ROUTE_ROOM);
+    message_handler_add(83, G_IDATA, MESSAGE_ROUTE_ROOM);
+    message_handler_add(84, SETITEMDATA, MESSAGE_ROUTE_ROOM);
 
     // Catalogue
-    message_requests[101] = GCIX;
-    message_requests[102] = GCAP;
-    message_requests[215] = GET_ALIAS_LIST;
-    message_requests[100] = GRPC;
+    message_handler_add(101, GCIX, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(102, GCAP, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(215, GET_ALIAS_LIST, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(100, GRPC, MESSAGE_ROUTE_HOTEL);
 
     // Inventory
-    message_requests[65] = GETSTRIP;
-    message_requests[66] = FLATPROPBYITEM;
+    message_handler_add(65, GETSTRIP, MESSAGE_ROUTE_HOTEL);
+    message_handler_add(66, FLATPROPBYITEM, MESSAGE_ROUTE_ROOM);
 
     // Trax
-    message_requests[244] = GET_SONG_LIST;
+    message_handler_add(244, GET_SONG_LIST, MESSAGE_ROUTE_HOTEL);
+
+    for (size_t i = 0; i < sizeof(packet_whitelist) / sizeof(packet_whitelist[0]); i++) {
+        message_table[packet_whitelist[i]].requires_login = false;
+    }
+
+    // Rate limit classes, everything else shares the default class
+    message_table[75].rate = MESSAGE_RATE_WALK;
+    message_table[52].rate = MESSAGE_RATE_CHAT;
+    message_table[55].rate = MESSAGE_RATE_CHAT;
+    message_table[2].rate = MESSAGE_RATE_ROOM_ENTRY;
+    message_table[57].rate = MESSAGE_RATE_ROOM_ENTRY;
+    message_table[59].rate = MESSAGE_RATE_ROOM_ENTRY;
+    message_table[90].rate = MESSAGE_RATE_ITEM;
+    message_table[73].rate = MESSAGE_RATE_ITEM;
+    message_table[67].rate = MESSAGE_RATE_ITEM;
+    message_table[99].rate = MESSAGE_RATE_ITEM;
+    message_table[74].rate = MESSAGE_RATE_ITEM;
+    message_table[100].rate = MESSAGE_RATE_ITEM;
+
+    // Messages with a fixed body
+    message_table[196].max_length = 0;
+    message_table[75].max_length = 4; // two B64 coordinates
 }
 
 /**
- * Retrieves the handler by header id
+ * Register the handler of a header, it requires the session to be logged in and
+ * accepts any length until told otherwise.
+ *
+ * @param header_id the header id
+ * @param handle the handler
+ * @param route the actor the handler runs on
+ */
+void message_handler_add(int header_id, mh_request handle, message_route route) {
+    message_entry *entry = &message_table[header_id];
+    entry->handle = handle;
+    entry->route = route;
+    entry->rate = MESSAGE_RATE_DEFAULT;
+    entry->requires_login = true;
+    entry->max_length = MESSAGE_MAX_CONTENT_LENGTH;
+
+    if (entry->stats == NULL) {
+        entry->stats = message_stats_create(header_id);
+    }
+}
+
+/**
+ * Hands the message to the actor owning the state its handler touches, called by the
+ * loop owning the session. Messages of a session are posted in the order they were
+ * received, the room they're routed to is tracked by the loop.
+ *
  * @param im the incoming message struct
  * @param player the player struct
  */
 void message_handler_invoke(incoming_message *im, session *player) {
-    if (configuration_get_bool("debug")) {
+    if (global.configuration.debug) {
         char *preview = replace_unreadable_characters(im->data);
         log_debug("Client [%s] incoming data: %i / %s", player->ip_address, im->header_id, preview);
         free(preview);
     }
 
     // Stop the server from crashing
-    if (im->header_id > 9999 || im->header_id < 0) {
+    if (im->header_id >= MESSAGES || im->header_id < 0) {
+        return;
+    }
+
+    const message_entry *entry = &message_table[im->header_id];
+
+    // Don't process any headers it can't find, or bodies longer than the message can have
+    if (entry->handle == NULL || im_remaining(im) > entry->max_length) {
         return;
     }
 
-    // Don't process any headers it can't find
-    if (message_requests[im->header_id] == NULL) {
+    // If the user isn't logged in, we only process whitelisted headers. Nothing else may cost
+    // the server anything, such as loading the room the message is routed to
+    if (entry->requires_login && !atomic_load(&player->logged_in)) {
         return;
     }
 
-    mh_request handle = message_requests[im->header_id];
+    // A newer walk target replaces the one still waiting for the room, it doesn't need a message of its own
+    bool coalesced = entry->rate == MESSAGE_RATE_WALK && im_remaining(im) == MESSAGE_COALESCE_LENGTH;
 
-    if (player->logged_in) {
-        handle(player, im);
-    } else {
+    if (coalesced && message_handler_coalesce(player, im)) {
+        return;
+    }
+
+    if (!message_handler_take_token(player, entry->rate)) {
+        message_stats_record_limited(entry->stats);
+
+        if (coalesced) {
+            atomic_store(&player->coalesce_pending, false);
+        }
+
+        return;
+    }
+
+    // Only touches state owned by the loop, so there's no need to hand it to an actor
+    if (entry->route == MESSAGE_ROUTE_LOOP) {
+        uint64_t started = scheduler_now();
+        entry->handle(player, im);
+        message_stats_record(entry->stats, im->total_length, started);
+        return;
+    }
 
-        // If the user isn't logged in, we only process whitelisted headers.
-        for (int i = 0; i < (sizeof(packet_whitelist) / sizeof(packet_whitelist[0])); i++) {
-            int header_id = packet_whitelist[i];
+    // The incoming message is a view over the read buffer, the actor needs its own copy
+    message_command *command = malloc(sizeof(message_command) + im->total_length + 1);
+    command->player = player_retain(player);
+    command->handle = entry->handle;
+    command->stats = entry->stats;
+    command->room_member_only = true;
+    command->coalesced = coalesced;
+    command->length = im->total_length;
+    memcpy(command->frame, im->data, (size_t) im->total_length);
+    command->frame[im->total_length] = '\0';
+
+    message_route route = entry->route;
+    int room_id = player->route_room_id;
+
+    if (route == MESSAGE_ROUTE_ROOM_ENTRY || route == MESSAGE_ROUTE_ROOM_TARGET) {
+        room_id = message_handler_target_room(im);
+        command->room_member_only = false;
+    }
 
-            if (header_id == im->header_id) {
-                handle(player, im);
+    switch (route) {
+        case MESSAGE_ROUTE_ROOM_ENTRY:
+            message_handler_enter_room(player, room_id, command);
+            return;
+        case MESSAGE_ROUTE_ROOM_EXIT:
+            player->route_room_id = 0;
+            // Fall through, the room still handles the message
+        case MESSAGE_ROUTE_ROOM:
+            if (!room_manager_post(room_id, message_handler_execute, command, message_handler_release)) {
+                message_handler_release(command);
             }
+            return;
+        case MESSAGE_ROUTE_ROOM_TARGET:
+            if (room_manager_post(room_id, message_handler_execute, command, message_handler_release)) {
+                return;
+            }
+            // Fall through, rooms that aren't loaded are handled by the hotel
+        default:
+            break;
+    }
+
+    actor_post(global.thread_manager.hotel, message_handler_execute, command, message_handler_release);
+}
+
+/**
+ * Take a token from the session's bucket of the rate class, called by the loop owning
+ * the session so the buckets need no locking.
+ *
+ * @param player the player struct
+ * @param rate the rate class of the message
+ * @return true, if the message may be processed
+ */
+bool message_handler_take_token(session *player, message_rate rate) {
+    const message_rate_limit *limit = &rate_limits[rate];
+    message_bucket *bucket = &player->rate_buckets[rate];
+
+    uint64_t now = uv_now(((uv_handle_t *) player->stream)->loop);
+    long capacity = limit->burst * 1000L;
+
+    if (bucket->updated == 0) {
+        bucket->tokens = capacity;
+    } else {
+        // A token is a thousand, so every millisecond adds per_second of them
+        bucket->tokens += (long) (now - bucket->updated) * limit->per_second;
+
+        if (bucket->tokens > capacity) {
+            bucket->tokens = capacity;
+        }
+    }
+
+    bucket->updated = now;
+
+    if (bucket->tokens < 1000) {
+        return false;
+    }
+
+    bucket->tokens -= 1000;
+    return true;
+}
+
+/**
+ * Store the body of a message that only the latest of matters, such as a walk target.
+ *
+ * @param player the player struct
+ * @param im the incoming message struct, its body is MESSAGE_COALESCE_LENGTH long
+ * @return true, if a message waiting for its actor will pick up the body, false if the
+ * message has to be posted
+ */
+bool message_handler_coalesce(session *player, incoming_message *im) {
+    int length;
+    const char *content = im_get_content_view(im, &length);
+
+    unsigned int body;
+    memcpy(&body, content, MESSAGE_COALESCE_LENGTH);
+
+    atomic_store(&player->coalesced_body, body);
+    return atomic_exchange(&player->coalesce_pending, true);
+}
+
+/**
+ * Read the room a room entry message is about, without moving the message forward.
+ *
+ * @param im the incoming message struct
+ * @return the room id, -1 if the message isn't about a room
+ */
+int message_handler_target_room(incoming_message *im) {
+    int length;
+    const char *content = im_get_content_view(im, &length);
+
+    if (length <= 0) {
+        return -1;
+    }
+
+    // Public rooms are entered through the room directory, private rooms through TRYFLAT and GOTOFLAT
+    if (im->header_id == 2) {
+        if (content[0] != 'A' || length < 2) {
+            return -1;
         }
+
+        int len;
+        return vl64_decode(content + 1, &len);
+    }
+
+    if (!isdigit(content[0])) {
+        return -1;
+    }
+
+    return (int) strtol(content, NULL, 10);
+}
+
+/**
+ * Route the session to a new room. The previous room is left through its own actor
+ * and the new room holds back the entry message, along with everything after it, until
+ * the session left the previous room.
+ *
+ * @param player the player struct
+ * @param room_id the room the session is entering
+ * @param command the room entry message
+ */
+void message_handler_enter_room(session *player, int room_id, message_command *command) {
+    if (room_id <= 0) {
+        actor_post(global.thread_manager.hotel, message_handler_execute, command, message_handler_release);
+        return;
+    }
+
+    room_manager_add(room_id);
+    actor_gate *gate = NULL;
+
+    if (player->route_room_id > 0 && player->route_room_id != room_id) {
+        gate = actor_gate_create();
+        room_post_leave(player->route_room_id, player, false, gate);
+        player->route_room_id = 0;
+    }
+
+    if (room_manager_post_after(room_id, gate, message_handler_execute, command, message_handler_release)) {
+        player->route_room_id = room_id;
+        return;
     }
-}
\ No newline at end of file
+
+    // The room doesn't exist, the hotel actor still answers the message
+    if (gate != NULL) {
+        actor_gate_release(gate);
+    }
+
+    actor_post(global.thread_manager.hotel, message_handler_execute, command, message_handler_release);
+}
+
+/**
+ * Run the handler of a message, called by the actor the message was routed to.
+ *
+ * @param state the room when run by a room actor, NULL when run by the hotel actor
+ * @param argument the message command
+ */
+void message_handler_execute(void *state, void *argument) {
+    message_command *command = argument;
+    session *player = command->player;
+
+    // Pick up the latest body, anything newer than this gets a message of its own
+    if (command->coalesced) {
+        command->coalesced = false;
+        atomic_store(&player->coalesce_pending, false);
+
+        unsigned int body = atomic_load(&player->coalesced_body);
+        memcpy(command->frame + 2, &body, MESSAGE_COALESCE_LENGTH);
+    }
+
+    if (player->disconnected) {
+        return;
+    }
+
+    incoming_message im;
+    im_init(&im, command->frame, command->length);
+
+    // A session routed to a room it isn't in anymore, for example after being kicked
+    if (state != NULL && command->room_member_only && (player->room_user == NULL || player->room_user->room != state)) {
+        return;
+    }
+
+    uint64_t started = scheduler_now();
+    command->handle(player, &im);
+    message_stats_record(command->stats, command->length, started);
+}
+
+/**
+ * Cleanup a message command.
+ *
+ * @param argument the message command
+ */
+void message_handler_release(void *argument) {
+    message_command *command = argument;
+
+    // Never executed, a newer message of the kind has to be posted again
+    if (command->coalesced) {
+        atomic_store(&command->player->coalesce_pending, false);
+    }
+
+    player_release(command->player);
+    free(command);
+}
@@ -1,15 +1,76 @@
 #ifndef MESSAGE_HANDLER_H
 #define MESSAGE_HANDLER_H
 
-#define MESSAGES 9999
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MESSAGES 4096 // every header a two character B64 value can hold
+#define MESSAGE_MAX_CONTENT_LENGTH 262141 // the largest body a three character B64 prefix frames, minus the header
+#define MESSAGE_COALESCE_LENGTH 4 // the body of a coalesced message has to fit in an int
 
 typedef struct incoming_message_s incoming_message;
 typedef struct session_s session;
+typedef struct message_stats_s message_stats;
 
 typedef void (*mh_request)(session*, incoming_message*);
-mh_request message_requests[MESSAGES];
 
+typedef enum message_route_e {
+    MESSAGE_ROUTE_HOTEL,
+    MESSAGE_ROUTE_LOOP,
+    MESSAGE_ROUTE_ROOM,
+    MESSAGE_ROUTE_ROOM_EXIT,
+    MESSAGE_ROUTE_ROOM_ENTRY,
+    MESSAGE_ROUTE_ROOM_TARGET
+} message_route;
+
+typedef enum message_rate_e {
+    MESSAGE_RATE_DEFAULT,
+    MESSAGE_RATE_WALK,
+    MESSAGE_RATE_CHAT,
+    MESSAGE_RATE_ROOM_ENTRY,
+    MESSAGE_RATE_ITEM,
+    MESSAGE_RATE_CLASSES
+} message_rate;
+
+typedef struct message_rate_limit_s {
+    int burst; // messages allowed at once
+    int per_second; // messages the bucket refills with each second
+} message_rate_limit;
+
+typedef struct message_bucket_s {
+    long tokens; // in thousandths of a message
+    uint64_t updated; // loop time in milliseconds, 0 if the bucket was never used
+} message_bucket;
+
+typedef struct message_entry_s {
+    mh_request handle;
+    message_route route;
+    message_rate rate;
+    bool requires_login;
+    int max_length; // the longest body accepted, without the header
+    message_stats *stats;
+} message_entry;
+
+extern message_entry message_table[MESSAGES];
+
+typedef struct message_command_s {
+    session *player;
+    mh_request handle;
+    message_stats *stats;
+    bool room_member_only;
+    bool coalesced;
+    int length;
+    char frame[];
+} message_command;
+
+void message_handler_add(int header_id, mh_request handle, message_route route);
 void message_handler_invoke(incoming_message *, session *);
+bool message_handler_take_token(session *, message_rate);
+bool message_handler_coalesce(session *, incoming_message *);
+int message_handler_target_room(incoming_message *);
+void message_handler_enter_room(session *, int room_id, message_command *);
+void message_handler_execute(void *state, void *argument);
+void message_handler_release(void *argument);
 void message_handler_init();
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,226 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#include "message_stats.h"
+#include "message_handler.h"
+
+#include "util/scheduler.h"
+#include "util/stringbuilder.h"
+
+#define MESSAGE_STATS_TOP 20
+
+// Outgoing traffic per header, only counted so there's no need to keep a histogram
+static message_traffic outgoing_traffic[MESSAGES];
+
+/**
+ * Create the counters of an incoming header.
+ *
+ * @param header_id the header id
+ * @return the counters
+ */
+message_stats *message_stats_create(int header_id) {
+    message_stats *stats = calloc(1, sizeof(message_stats));
+    stats->header_id = header_id;
+    return stats;
+}
+
+/**
+ * Get the histogram bucket a handler time falls in. Small values have a bucket each, after
+ * that every power of two is split in MESSAGE_STATS_SUB_BUCKETS buckets of equal width.
+ *
+ * @param nanos the handler time
+ * @return the bucket
+ */
+static int message_stats_bucket(uint64_t nanos) {
+    if (nanos < MESSAGE_STATS_SUB_BUCKETS) {
+        return (int) nanos;
+    }
+
+    int magnitude = 63 - __builtin_clzll(nanos);
+    int sub_bucket = (int) ((nanos >> (magnitude - 2)) & (MESSAGE_STATS_SUB_BUCKETS - 1));
+    int bucket = (magnitude - 1) * MESSAGE_STATS_SUB_BUCKETS + sub_bucket;
+
+    return bucket < MESSAGE_STATS_BUCKETS ? bucket : MESSAGE_STATS_BUCKETS - 1;
+}
+
+/**
+ * Get the lowest handler time that falls in a bucket.
+ *
+ * @param bucket the bucket
+ * @return the handler time in nanoseconds
+ */
+static uint64_t message_stats_bucket_floor(int bucket) {
+    if (bucket < MESSAGE_STATS_SUB_BUCKETS) {
+        return (uint64_t) bucket;
+    }
+
+    int magnitude = bucket / MESSAGE_STATS_SUB_BUCKETS + 1;
+    uint64_t sub_bucket = (uint64_t) (bucket % MESSAGE_STATS_SUB_BUCKETS);
+
+    return (MESSAGE_STATS_SUB_BUCKETS + sub_bucket) << (magnitude - 2);
+}
+
+/**
+ * Record a handled message, called by whichever thread ran the handler.
+ *
+ * @param stats the counters of the header
+ * @param bytes the length of the message
+ * @param started the time the handler started, from scheduler_now()
+ */
+void message_stats_record(message_stats *stats, int bytes, uint64_t started) {
+    uint64_t nanos = scheduler_now() - started;
+
+    atomic_fetch_add_explicit(&stats->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->bytes, (unsigned long long) bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->total_nanos, nanos, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats->histogram[message_stats_bucket(nanos)], 1, memory_order_relaxed);
+
+    unsigned long long max = atomic_load_explicit(&stats->max_nanos, memory_order_relaxed);
+
+    while (nanos > max && !atomic_compare_exchange_weak_explicit(&stats->max_nanos, &max, nanos,
+                                                                memory_order_relaxed, memory_order_relaxed)) {
+        // max was reloaded, try again while this call is still the slowest
+    }
+}
+
+/**
+ * Record a message that was dropped because the session sent too many of its rate class.
+ *
+ * @param stats the counters of the header
+ */
+void message_stats_record_limited(message_stats *stats) {
+    atomic_fetch_add_explicit(&stats->limited, 1, memory_order_relaxed);
+}
+
+/**
+ * Record an outgoing message.
+ *
+ * @param header_id the header id
+ * @param bytes the length of the message
+ * @param recipients the amount of sessions it was sent to
+ */
+void message_stats_record_sent(int header_id, int bytes, int recipients) {
+    if (header_id < 0 || header_id >= MESSAGES) {
+        return;
+    }
+
+    message_traffic *traffic = &outgoing_traffic[header_id];
+    atomic_fetch_add_explicit(&traffic->sent, (unsigned long long) recipients, memory_order_relaxed);
+    atomic_fetch_add_explicit(&traffic->bytes, (unsigned long long) bytes * recipients, memory_order_relaxed);
+}
+
+/**
+ * Estimate a handler time percentile from the histogram.
+ *
+ * @param stats the counters of the header
+ * @param percentile the percentile, between 0 and 100
+ * @return the handler time in nanoseconds, accurate to the width of its bucket
+ */
+uint64_t message_stats_percentile(message_stats *stats, double percentile) {
+    unsigned long long total = 0;
+    unsigned long long counts[MESSAGE_STATS_BUCKETS];
+
+    for (int i = 0; i < MESSAGE_STATS_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&stats->histogram[i], memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    unsigned long long wanted = (unsigned long long) (total * percentile / 100.0);
+    unsigned long long seen = 0;
+
+    for (int i = 0; i < MESSAGE_STATS_BUCKETS; i++) {
+        seen += counts[i];
+
+        if (seen > wanted) {
+            return message_stats_bucket_floor(i);
+        }
+    }
+
+    return message_stats_bucket_floor(MESSAGE_STATS_BUCKETS - 1);
+}
+
+static int message_stats_compare_time(const void *a, const void *b) {
+    unsigned long long first = atomic_load_explicit(&(*(message_stats**) a)->total_nanos, memory_order_relaxed);
+    unsigned long long second = atomic_load_explicit(&(*(message_stats**) b)->total_nanos, memory_order_relaxed);
+    return (first < second) - (first > second);
+}
+
+static int message_stats_compare_bytes(const void *a, const void *b) {
+    unsigned long long first = atomic_load_explicit(&outgoing_traffic[*(int*) a].bytes, memory_order_relaxed);
+    unsigned long long second = atomic_load_explicit(&outgoing_traffic[*(int*) b].bytes, memory_order_relaxed);
+    return (first < second) - (first > second);
+}
+
+/**
+ * Append a readable report of the handlers that took the most time in total, and
+ * the outgoing headers that sent the most bytes.
+ *
+ * @param sb the stringbuilder to write the report to
+ */
+void message_stats_append(stringbuilder *sb) {
+    message_stats *handlers[MESSAGES];
+    int handler_count = 0;
+
+    for (int i = 0; i < MESSAGES; i++) {
+        message_stats *stats = message_table[i].stats;
+
+        if (stats != NULL && (atomic_load_explicit(&stats->calls, memory_order_relaxed) > 0
+                              || atomic_load_explicit(&stats->limited, memory_order_relaxed) > 0)) {
+            handlers[handler_count++] = stats;
+        }
+    }
+
+    qsort(handlers, (size_t) handler_count, sizeof(message_stats*), message_stats_compare_time);
+
+    char line[160];
+    sb_add_string(sb, "header      calls    limited   bytes in   total ms    avg us    p50 us    p99 us    max us\n");
+
+    for (int i = 0; i < handler_count && i < MESSAGE_STATS_TOP; i++) {
+        message_stats *stats = handlers[i];
+
+        unsigned long long calls = atomic_load_explicit(&stats->calls, memory_order_relaxed);
+        unsigned long long total = atomic_load_explicit(&stats->total_nanos, memory_order_relaxed);
+
+        snprintf(line, sizeof(line), "%6i %10llu %10llu %10llu %10.2f %9.1f %9.1f %9.1f %9.1f\n",
+                 stats->header_id,
+                 calls,
+                 atomic_load_explicit(&stats->limited, memory_order_relaxed),
+                 atomic_load_explicit(&stats->bytes, memory_order_relaxed),
+                 total / 1e6,
+                 calls > 0 ? (double) total / calls / 1e3 : 0.0,
+                 message_stats_percentile(stats, 50) / 1e3,
+                 message_stats_percentile(stats, 99) / 1e3,
+                 atomic_load_explicit(&stats->max_nanos, memory_order_relaxed) / 1e3);
+
+        sb_add_string(sb, line);
+    }
+
+    int outgoing[MESSAGES];
+    int outgoing_count = 0;
+
+    for (int i = 0; i < MESSAGES; i++) {
+        if (atomic_load_explicit(&outgoing_traffic[i].sent, memory_order_relaxed) > 0) {
+            outgoing[outgoing_count++] = i;
+        }
+    }
+
+    qsort(outgoing, (size_t) outgoing_count, sizeof(int), message_stats_compare_bytes);
+    sb_add_string(sb, "outgoing     sent  bytes out\n");
+
+    for (int i = 0; i < outgoing_count && i < MESSAGE_STATS_TOP; i++) {
+        message_traffic *traffic = &outgoing_traffic[outgoing[i]];
+
+        snprintf(line, sizeof(line), "%6i %10llu %10llu\n",
+                 outgoing[i],
+                 atomic_load_explicit(&traffic->sent, memory_order_relaxed),
+                 atomic_load_explicit(&traffic->bytes, memory_order_relaxed));
+
+        sb_add_string(sb, line);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef MESSAGE_STATS_H
+#define MESSAGE_STATS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define MESSAGE_STATS_SUB_BUCKETS 4 // every power of two is split in four, about 25% precision
+#define MESSAGE_STATS_BUCKETS 144 // up to 2^36 nanoseconds, anything slower lands in the last bucket
+
+typedef struct stringbuilder_s stringbuilder;
+
+typedef struct message_stats_s {
+    int header_id;
+    atomic_ullong calls;
+    atomic_ullong bytes;
+    atomic_ullong limited;
+    atomic_ullong total_nanos;
+    atomic_ullong max_nanos;
+    atomic_ullong histogram[MESSAGE_STATS_BUCKETS];
+} message_stats;
+
+typedef struct message_traffic_s {
+    atomic_ullong sent;
+    atomic_ullong bytes;
+} message_traffic;
+
+message_stats *message_stats_create(int header_id);
+void message_stats_record(message_stats *stats, int bytes, uint64_t started);
+void message_stats_record_limited(message_stats *stats);
+void message_stats_record_sent(int header_id, int bytes, int recipients);
+uint64_t message_stats_percentile(message_stats *stats, double percentile);
+void message_stats_append(stringbuilder *sb);
+
+#endif
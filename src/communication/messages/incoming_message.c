@@ -4,130 +4,178 @@
 #include "util/encoding/vl64encoding.h"
 
 /**
- * Creates an incoming message give by a char array
- * @param message the char array
- * @return incoming_message struct
+ * Initialise an incoming message as a view over a received frame, nothing is copied
+ * or allocated. The frame has to stay alive and zero terminated at the given length
+ * for as long as the message is used.
+ *
+ * @param im the incoming message to initialise
+ * @param frame the frame, starting with the B64 header
+ * @param length the length of the frame
  */
-incoming_message *im_create(char *message) {
-    incoming_message *im = malloc(sizeof(incoming_message));
-    im->data = message;
+void im_init(incoming_message *im, char *frame, int length) {
+    im->data = frame;
     im->counter = 0;
-    im->total_length = (int)strlen(message);
-    im->header = im_read_b64(im);
-    im->header_id = base64_decode(im->header);
-    return im;
+    im->total_length = length;
+    im->header_id = im_read_b64_int(im);
 }
 
 /**
- * Read base64 character, use free() on this returned value after using this.
+ * Get the amount of unread bytes left in the message.
  *
  * @param im the incoming message
- * @return the base64 value
+ * @return the unread byte count
  */
-char *im_read_b64(incoming_message *im) {
-    if ((im->counter - 2) > im->total_length) {
-        return NULL;
-    }
-
-    char data[] = {
-        im->data[im->counter++],
-        im->data[im->counter++],
-        '\0'
-    };
-
-    return strdup(data);
+int im_remaining(incoming_message *im) {
+    return im->total_length - im->counter;
 }
 
 /**
- * Read a B64 as an integer.
+ * Read a two character B64 value as an integer.
  *
  * @param im the incoming message
- * @return the integer
+ * @return the integer, or -1 if there are not enough bytes left
  */
 int im_read_b64_int(incoming_message *im) {
-    if ((im->counter - 2) > im->total_length) {
+    if (im_remaining(im) < 2) {
         return -1;
     }
 
-    char data[] = {
-        im->data[im->counter++],
-        im->data[im->counter++],
-        '\0'
-    };
+    int value = base64_decode_length(im->data + im->counter, 2);
+    im->counter += 2;
 
-    return base64_decode(data);
+    return value;
 }
 
 /**
- * Read vl64 character as an integer
+ * Read vl64 character as an integer, decoded directly at the read position.
  *
  * @param im the incoming message
- * @return the integer value
+ * @return the integer value, or -1 if the value runs past the end of the message
  */
 int im_read_vl64(incoming_message *im) {
-    if ((im->counter - 2) > im->total_length) {
+    if (im_remaining(im) < 1) {
         return -1;
     }
 
-    char *str = im_get_content(im);
+    int total_bytes = (im->data[im->counter] >> 3) & 7;
+
+    if (total_bytes == 0 || total_bytes > im_remaining(im)) {
+        return -1;
+    }
 
     int length;
-    int val = vl64_decode(str, &length);
+    int val = vl64_decode(im->data + im->counter, &length);
     im->counter += length;
 
-    free(str);
     return val;
 }
 
 /**
- * Get rest of the packet, without header
+ * Read a B64 length prefixed string as a view into the message. The view is not
+ * zero terminated.
  *
  * @param im the incoming message
- * @return the integer value
+ * @param length set to the length of the string
+ * @return the pointer to the first character, or NULL if the string runs past the end of the message
  */
-char *im_get_content(incoming_message *im) {
-    if ((im->counter - 2) > im->total_length) {
+const char *im_read_str_view(incoming_message *im, int *length) {
+    int str_length = im_read_b64_int(im);
+
+    if (str_length < 0 || str_length > im_remaining(im)) {
+        *length = 0;
         return NULL;
     }
 
-    int substring = im->counter;
-    int new_len = (int)strlen(im->data) - substring;
+    const char *str = im->data + im->counter;
+    im->counter += str_length;
+
+    *length = str_length;
+    return str;
+}
+
+/**
+ * Get the rest of the packet as a view into the message. As the frame itself is zero
+ * terminated, the view can be used as a regular string.
+ *
+ * @param im the incoming message
+ * @param length set to the length of the content
+ * @return the pointer to the content
+ */
+const char *im_get_content_view(incoming_message *im, int *length) {
+    if (im_remaining(im) < 0) {
+        *length = 0;
+        return im->data + im->total_length;
+    }
+
+    *length = im_remaining(im);
+    return im->data + im->counter;
+}
+
+/**
+ * Read a B64 length prefixed string into a caller supplied buffer, the string is
+ * truncated to fit and always zero terminated.
+ *
+ * @param im the incoming message
+ * @param buffer the buffer to copy into
+ * @param size the size of the buffer
+ * @return the amount of characters copied, or -1 if the string was not readable
+ */
+int im_read_str_into(incoming_message *im, char *buffer, size_t size) {
+    int length;
+    const char *str = im_read_str_view(im, &length);
+
+    if (str == NULL || size == 0) {
+        return -1;
+    }
+
+    if ((size_t) length >= size) {
+        length = (int) size - 1;
+    }
+
+    memcpy(buffer, str, (size_t) length);
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * Get rest of the packet, without header, use free() on this returned value after using this.
+ *
+ * @param im the incoming message
+ * @return the copied content
+ */
+char *im_get_content(incoming_message *im) {
+    int length;
+    const char *content = im_get_content_view(im, &length);
 
-    char *new_str = malloc((new_len + 1) * sizeof(char));
-    memcpy(new_str, &im->data[substring], strlen(im->data) - substring);
-    new_str[new_len] = '\0';
+    char *new_str = malloc((length + 1) * sizeof(char));
+    memcpy(new_str, content, (size_t) length);
+    new_str[length] = '\0';
 
     return new_str;
 }
 
 /**
- * Read base64 character, use free() on this returned value after using this.
+ * Read B64 length prefixed string, use free() on this returned value after using this.
  *
  * @param im the incoming message
- * @return the base64 value
+ * @return the copied string, or NULL if it could not be read
  */
 char *im_read_str(incoming_message *im) {
-    if ((im->counter - 2) > im->total_length) {
+    int length;
+    const char *view = im_read_str_view(im, &length);
+
+    if (view == NULL) {
         return NULL;
     }
 
-    char *recv_length = im_read_b64(im);
-    int length = base64_decode(recv_length);
-
     char *str = malloc((length + 1) * sizeof(char));
 
     if (str) {
-        for (int i = 0; i < length; i++) {
-            str[i] = im->data[im->counter++];
-        }
-
+        memcpy(str, view, (size_t) length);
         str[length] = '\0';
-        free(recv_length);
-
-        return str;
-    } else {
-        return NULL;
     }
+
+    return str;
 }
 
 /**
@@ -135,17 +183,11 @@ char *im_read_str(incoming_message *im) {
  *
  * @param im the incoming message instance
  * @param amount_read the amount of bytes to read
- * @return none
  */
-void *im_read(incoming_message *im, int amount_read) {
-    im->counter += amount_read;
-}
+void im_read(incoming_message *im, int amount_read) {
+    if (amount_read > im_remaining(im)) {
+        amount_read = im_remaining(im);
+    }
 
-/**
- * Cleanup any variables loaded on the heap that had to do with this struct
- * @param im the incoming message
- */
-void im_cleanup(incoming_message *im) {
-    free(im->header);
-    free(im);
+    im->counter += amount_read;
 }
@@ -3,21 +3,24 @@
 
 #include "shared.h"
 
+#define MAX_MESSAGE_LENGTH 5120
+
 typedef struct incoming_message_s {
-    char *header;
     char *data;
     int counter;
     int header_id;
     int total_length;
 } incoming_message;
 
-incoming_message *im_create(char*);
-char *im_read_b64(incoming_message*);
+void im_init(incoming_message*, char*, int);
+int im_remaining(incoming_message*);
 int im_read_b64_int(incoming_message*);
 int im_read_vl64(incoming_message*);
+const char *im_read_str_view(incoming_message*, int*);
+const char *im_get_content_view(incoming_message*, int*);
+int im_read_str_into(incoming_message*, char*, size_t);
 char *im_get_content(incoming_message*);
 char *im_read_str(incoming_message *);
-void *im_read(incoming_message *, int);
-void im_cleanup(incoming_message*);
+void im_read(incoming_message *, int);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,4 +1,5 @@
 #include "outgoing_message.h"
+#include "packet_registry.h"
 
 #include "util/stringbuilder.h"
 
@@ -7,19 +8,40 @@
 
 #include <shared.h>
 
+_Thread_local outgoing_message *om_pool = NULL;
+_Thread_local int om_pool_size = 0;
+
 /**
- * Creates an outgoing message struct with the specified header
+ * Creates an outgoing message struct with the specified header. Messages are taken
+ * from a per thread pool when possible, their buffer is reused as well.
+ *
  * @param header the b64 header
  * @return the outgoing message
  */
 outgoing_message *om_create(int header) {
-    outgoing_message *om = malloc(sizeof(outgoing_message));
+    outgoing_message *om = om_pool;
+
+    if (om != NULL) {
+        om_pool = om->next_free;
+        om_pool_size--;
+        sb_reset(om->sb);
+    } else {
+        om = malloc(sizeof(outgoing_message));
+        om->sb = sb_create();
+    }
+
     om->header_id = header;
-    om->header = base64_encode(om->header_id, 2);
     om->finalised = 0;
-    om->sb = sb_create();
+    om->next_free = NULL;
+
+    if (header >= 0 && header < PACKET_HEADER_COUNT) {
+        sb_add_bytes(om->sb, packet_registry_header(header), 2);
+    } else {
+        char encoded[2];
+        base64_encode_into(encoded, header, 2);
+        sb_add_bytes(om->sb, encoded, 2);
+    }
 
-    sb_add_string(om->sb, om->header);
     return om;
 }
 
@@ -40,7 +62,7 @@ void om_write_str(outgoing_message *om, char *str) {
 
 void om_write_str_kv(outgoing_message *om, char *key, char *value) {
     sb_add_string(om->sb, key);
-    sb_add_string(om->sb, ":");
+    sb_add_char(om->sb, ':');
     sb_add_string(om->sb, value);
     sb_add_char(om->sb, 13);
 }
@@ -63,10 +85,7 @@ void om_write_str_delimeter(outgoing_message *om, char *str, int delim) {
  * @param str the string to write
  */
 void om_write_int_delimeter(outgoing_message *om, int num, int delim) {
-    char var[11];
-    sprintf(var, "%i", num);
-
-    sb_add_string(om->sb, var);
+    sb_add_int(om->sb, num);
     sb_add_char(om->sb, delim);
 }
 
@@ -80,9 +99,7 @@ void om_write_char(outgoing_message *om, int character) {
  * @param str the string to write
  */
 void om_write_str_int(outgoing_message *om, int num) {
-    char var[11];
-    sprintf(var, "%i", num);
-    om_write_str(om, var);
+    sb_add_int_delimeter(om->sb, num, 2);
 }
 
 /**
@@ -91,9 +108,7 @@ void om_write_str_int(outgoing_message *om, int num) {
  * @param str the int to write
  */
 void om_write_int(outgoing_message *om, int num) {
-    char *encoded = vl64_encode(num);
-    sb_add_string(om->sb, encoded);
-    free(encoded);
+    sb_add_wired(om->sb, num);
 }
 
 /**
@@ -109,18 +124,29 @@ void om_finalise(outgoing_message *om) {
         return;
     }
 
-    sb_add_string(om->sb, "\1");
+    sb_add_char(om->sb, 1);
     om->finalised = 1;
 }
 
 /**
- * Cleanup any variables loaded on the heap that had to do with this struct
+ * Hand the message back to the pool of the current thread unless the pool is full,
+ * a message that grew too large gives its memory back first.
+ *
  * @param om the outgoing message
  */
 void om_cleanup(outgoing_message *om) {
+    if (om_pool_size < OM_POOL_SIZE) {
+        if (om->sb->capacity > OM_POOL_MAX_CAPACITY) {
+            sb_reset(om->sb);
+            sb_shrink(om->sb, SB_DEFAULT_CAPACITY);
+        }
+
+        om->next_free = om_pool;
+        om_pool = om;
+        om_pool_size++;
+        return;
+    }
+
     sb_cleanup(om->sb);
-    free(om->header);
     free(om);
-    
-    om = NULL;
 }
\ No newline at end of file
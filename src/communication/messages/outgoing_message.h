@@ -1,14 +1,17 @@
 #ifndef OUTGOING_MESSAGE_H
 #define OUTGOING_MESSAGE_H
 
+#define OM_POOL_SIZE 32
+#define OM_POOL_MAX_CAPACITY (64 * 1024)
+
 typedef struct session_s session;
 typedef struct stringbuilder_s stringbuilder;
 
 typedef struct outgoing_message_s {
     int header_id;
-    char *header;
     int finalised;
     stringbuilder *sb;
+    struct outgoing_message_s *next_free;
 } outgoing_message;
 
 outgoing_message *om_create(int);
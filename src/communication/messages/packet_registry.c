@@ -0,0 +1,88 @@
+#include "shared.h"
+
+#include "packet_registry.h"
+#include "outgoing_message.h"
+
+#include "util/shared_buffer.h"
+#include "util/stringbuilder.h"
+#include "util/encoding/base64encoding.h"
+
+char packet_headers[PACKET_HEADER_COUNT][2];
+shared_buffer *prebuilt_packets[PACKET_PREBUILT_COUNT];
+
+static shared_buffer *packet_registry_build(outgoing_message *om);
+
+/**
+ * Encode the header of every packet id that fits in two B64 characters, and build
+ * the packets that never change so they can be queued for any session by reference.
+ */
+void packet_registry_init() {
+    for (int header_id = 0; header_id < PACKET_HEADER_COUNT; header_id++) {
+        base64_encode_into(packet_headers[header_id], header_id, 2);
+    }
+
+    outgoing_message *om;
+
+    om = om_create(0); // "@@"
+    prebuilt_packets[PACKET_HELLO] = packet_registry_build(om);
+
+    om = om_create(50); // "@r"
+    prebuilt_packets[PACKET_PING] = packet_registry_build(om);
+
+    om = om_create(2); // "@B"
+    om_write_str(om, "default\2fuse_login\2fuse_buy_credits\2fuse_trade\2fuse_room_queue_default\2fuse_performance_panel");
+    prebuilt_packets[PACKET_FUSE_RIGHTS] = packet_registry_build(om);
+
+    om = om_create(3); // "@C"
+    prebuilt_packets[PACKET_LOGIN_OK] = packet_registry_build(om);
+
+    om = om_create(166); // "Bf"
+    om_write_str(om, "/client/");
+    prebuilt_packets[PACKET_ROOM_URL] = packet_registry_build(om);
+}
+
+/**
+ * Get the pre-encoded B64 header of a packet id, which is not zero terminated.
+ *
+ * @param header_id the packet id, lower than PACKET_HEADER_COUNT
+ * @return the two header characters
+ */
+const char *packet_registry_header(int header_id) {
+    return packet_headers[header_id];
+}
+
+/**
+ * Get a prebuilt packet, the registry keeps its own reference so the buffer can be
+ * queued with player_send_buffer as is.
+ *
+ * @param packet the packet
+ * @return the finalised packet
+ */
+shared_buffer *packet_registry_get(prebuilt_packet packet) {
+    return prebuilt_packets[packet];
+}
+
+/**
+ * Release the prebuilt packets, sessions that still have one queued keep theirs.
+ */
+void packet_registry_dispose() {
+    for (int i = 0; i < PACKET_PREBUILT_COUNT; i++) {
+        shared_buffer_release(prebuilt_packets[i]);
+        prebuilt_packets[i] = NULL;
+    }
+}
+
+/**
+ * Finalise the message into an immutable buffer and clean the message up.
+ *
+ * @param om the outgoing message
+ * @return the shared buffer
+ */
+static shared_buffer *packet_registry_build(outgoing_message *om) {
+    om_finalise(om);
+
+    shared_buffer *buffer = shared_buffer_create(om->sb->data, (size_t) om->sb->index);
+    om_cleanup(om);
+
+    return buffer;
+}
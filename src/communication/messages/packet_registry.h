@@ -0,0 +1,22 @@
+#ifndef PACKET_REGISTRY_H
+#define PACKET_REGISTRY_H
+
+#define PACKET_HEADER_COUNT 4096
+
+typedef struct shared_buffer_s shared_buffer;
+
+typedef enum prebuilt_packet_e {
+    PACKET_HELLO,
+    PACKET_PING,
+    PACKET_FUSE_RIGHTS,
+    PACKET_LOGIN_OK,
+    PACKET_ROOM_URL,
+    PACKET_PREBUILT_COUNT
+} prebuilt_packet;
+
+void packet_registry_init();
+const char *packet_registry_header(int header_id);
+shared_buffer *packet_registry_get(prebuilt_packet packet);
+void packet_registry_dispose();
+
+#endif
@@ -0,0 +1,157 @@
+#include "shared.h"
+
+#include "packet_schema.h"
+#include "packet_registry.h"
+#include "incoming_message.h"
+
+#include "game/player/player.h"
+
+#include "util/shared_buffer.h"
+#include "util/encoding/base64encoding.h"
+#include "util/encoding/vl64encoding.h"
+
+static bool schema_read_B64(incoming_message *im, int *value) {
+    if (im_remaining(im) < 2) {
+        return false;
+    }
+
+    *value = base64_decode_length(im->data + im->counter, 2);
+    im->counter += 2;
+    return true;
+}
+
+static bool schema_read_VL64(incoming_message *im, int *value) {
+    if (im_remaining(im) < 1) {
+        return false;
+    }
+
+    int length = (im->data[im->counter] >> 3) & 7;
+
+    if (length == 0 || length > im_remaining(im)) {
+        return false;
+    }
+
+    *value = vl64_decode(im->data + im->counter, &length);
+    im->counter += length;
+    return true;
+}
+
+static bool schema_read_STR(incoming_message *im, packet_string *value) {
+    value->data = im_read_str_view(im, &value->length);
+    return value->data != NULL;
+}
+
+static bool schema_read_BYTE(incoming_message *im, char *value) {
+    if (im_remaining(im) < 1) {
+        return false;
+    }
+
+    *value = im->data[im->counter++];
+    return true;
+}
+
+// Every field kind can be written, even the ones no outgoing packet uses yet
+__attribute__((unused)) static int schema_size_B64(int value) {
+    return 2;
+}
+
+static int schema_size_VL64(int value) {
+    return vl64_encoded_length(value);
+}
+
+static int schema_size_STR(const char *value) {
+    return (int) strlen(value == NULL ? "[null]" : value) + 1;
+}
+
+__attribute__((unused)) static int schema_size_BYTE(char value) {
+    return 1;
+}
+
+__attribute__((unused)) static int schema_write_B64(char *buffer, int value) {
+    base64_encode_into(buffer, value, 2);
+    return 2;
+}
+
+static int schema_write_VL64(char *buffer, int value) {
+    return vl64_encode_into(buffer, value);
+}
+
+static int schema_write_STR(char *buffer, const char *value) {
+    if (value == NULL) {
+        value = "[null]";
+    }
+
+    size_t length = strlen(value);
+    memcpy(buffer, value, length);
+    buffer[length] = 2;
+
+    return (int) length + 1;
+}
+
+__attribute__((unused)) static int schema_write_BYTE(char *buffer, char value) {
+    buffer[0] = value;
+    return 1;
+}
+
+#define SCHEMA_DECODE_FIELD(kind, name) \
+    if (!schema_read_##kind(im, &packet->name)) { \
+        return false; \
+    }
+
+#define SCHEMA_INCOMING_DEFINE(name, header, fields) \
+    bool name##_packet_decode(incoming_message *im, name##_packet *packet) { \
+        if (im->header_id != (header)) { \
+            return false; \
+        } \
+        fields(SCHEMA_DECODE_FIELD) \
+        return true; \
+    }
+
+#define SCHEMA_SIZE_FIELD(kind, name) + schema_size_##kind(packet->name)
+#define SCHEMA_WRITE_FIELD(kind, name) length += schema_write_##kind(buffer + length, packet->name);
+
+#define SCHEMA_OUTGOING_DEFINE(name, header, fields) \
+    int name##_packet_size(const name##_packet *packet) { \
+        return 2 fields(SCHEMA_SIZE_FIELD) + 1; \
+    } \
+    int name##_packet_encode(const name##_packet *packet, char *buffer) { \
+        memcpy(buffer, packet_registry_header(header), 2); \
+        int length = 2; \
+        fields(SCHEMA_WRITE_FIELD) \
+        buffer[length++] = 1; \
+        return length; \
+    } \
+    shared_buffer *name##_packet_build(const name##_packet *packet) { \
+        shared_buffer *buffer = shared_buffer_allocate((size_t) name##_packet_size(packet)); \
+        name##_packet_encode(packet, buffer->data); \
+        return buffer; \
+    } \
+    void name##_packet_send(session *player, const name##_packet *packet) { \
+        shared_buffer *buffer = name##_packet_build(packet); \
+        player_send_buffer(player, buffer); \
+        shared_buffer_release(buffer); \
+    }
+
+INCOMING_PACKETS(SCHEMA_INCOMING_DEFINE)
+OUTGOING_PACKETS(SCHEMA_OUTGOING_DEFINE)
+
+/**
+ * Copy a decoded string into a caller supplied buffer, the string is truncated to fit
+ * and always zero terminated.
+ *
+ * @param string the decoded string
+ * @param buffer the buffer to copy into
+ * @param size the size of the buffer
+ * @return the amount of characters copied
+ */
+int packet_string_copy(packet_string *string, char *buffer, size_t size) {
+    size_t length = (size_t) string->length;
+
+    if (length >= size) {
+        length = size - 1;
+    }
+
+    memcpy(buffer, string->data, length);
+    buffer[length] = '\0';
+    return (int) length;
+}
@@ -0,0 +1,127 @@
+#ifndef PACKET_SCHEMA_H
+#define PACKET_SCHEMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct incoming_message_s incoming_message;
+typedef struct session_s session;
+typedef struct shared_buffer_s shared_buffer;
+
+typedef struct packet_string_s {
+    const char *data;
+    int length;
+} packet_string;
+
+/*
+ * Packet layouts, every field is a kind followed by its name:
+ *
+ *   B64   two character B64 integer
+ *   VL64  VL64 integer
+ *   STR   B64 length prefixed string when incoming, a string ended by char 2 when outgoing
+ *   BYTE  a single raw character
+ *
+ * Every packet listed in INCOMING_PACKETS gets a struct named <name>_packet and a
+ * bounds checked <name>_packet_decode, decoded strings are views into the message.
+ * Every packet listed in OUTGOING_PACKETS gets <name>_packet_size, which is exact,
+ * <name>_packet_encode, <name>_packet_build and <name>_packet_send.
+ */
+
+#define WALK_FIELDS(FIELD) \
+    FIELD(B64, x) \
+    FIELD(B64, y)
+
+#define RATE_FLAT_FIELDS(FIELD) \
+    FIELD(VL64, answer)
+
+#define GET_FLAT_CATEGORY_FIELDS(FIELD) \
+    FIELD(VL64, room_id)
+
+#define NAVIGATE_FIELDS(FIELD) \
+    FIELD(VL64, hide_full) \
+    FIELD(VL64, category_id)
+
+#define FAVOURITE_ROOM_FIELDS(FIELD) \
+    FIELD(VL64, room_type) \
+    FIELD(VL64, room_id)
+
+#define MESSENGER_MARK_READ_FIELDS(FIELD) \
+    FIELD(VL64, message_id)
+
+#define MESSENGER_REQUEST_BUDDY_FIELDS(FIELD) \
+    FIELD(STR, username)
+
+#define MESSENGER_REMOVE_BUDDY_FIELDS(FIELD) \
+    FIELD(BYTE, unknown) \
+    FIELD(VL64, friend_id)
+
+#define INCOMING_PACKETS(PACKET) \
+    PACKET(walk, 75, WALK_FIELDS) \
+    PACKET(rate_flat, 261, RATE_FLAT_FIELDS) \
+    PACKET(get_flat_category, 152, GET_FLAT_CATEGORY_FIELDS) \
+    PACKET(navigate, 150, NAVIGATE_FIELDS) \
+    PACKET(add_favourite_room, 19, FAVOURITE_ROOM_FIELDS) \
+    PACKET(remove_favourite_room, 20, FAVOURITE_ROOM_FIELDS) \
+    PACKET(messenger_mark_read, 32, MESSENGER_MARK_READ_FIELDS) \
+    PACKET(messenger_request_buddy, 39, MESSENGER_REQUEST_BUDDY_FIELDS) \
+    PACKET(messenger_remove_buddy, 40, MESSENGER_REMOVE_BUDDY_FIELDS)
+
+#define VOTE_COUNT_FIELDS(FIELD) \
+    FIELD(VL64, votes)
+
+#define FLAT_CATEGORY_FIELDS(FIELD) \
+    FIELD(VL64, room_id) \
+    FIELD(VL64, category_id)
+
+#define BUDDY_REQUEST_FIELDS(FIELD) \
+    FIELD(VL64, user_id) \
+    FIELD(STR, username)
+
+#define BUDDY_REMOVED_FIELDS(FIELD) \
+    FIELD(VL64, amount) \
+    FIELD(VL64, user_id)
+
+#define MESSENGER_MESSAGE_FIELDS(FIELD) \
+    FIELD(VL64, message_id) \
+    FIELD(VL64, sender_id) \
+    FIELD(STR, date) \
+    FIELD(STR, message)
+
+#define OUTGOING_PACKETS(PACKET) \
+    PACKET(vote_count, 345, VOTE_COUNT_FIELDS) \
+    PACKET(flat_category, 222, FLAT_CATEGORY_FIELDS) \
+    PACKET(buddy_request, 132, BUDDY_REQUEST_FIELDS) \
+    PACKET(buddy_removed, 138, BUDDY_REMOVED_FIELDS) \
+    PACKET(messenger_message, 134, MESSENGER_MESSAGE_FIELDS)
+
+// C types of the fields
+#define SCHEMA_INCOMING_TYPE_B64 int
+#define SCHEMA_INCOMING_TYPE_VL64 int
+#define SCHEMA_INCOMING_TYPE_STR packet_string
+#define SCHEMA_INCOMING_TYPE_BYTE char
+
+#define SCHEMA_OUTGOING_TYPE_B64 int
+#define SCHEMA_OUTGOING_TYPE_VL64 int
+#define SCHEMA_OUTGOING_TYPE_STR const char *
+#define SCHEMA_OUTGOING_TYPE_BYTE char
+
+#define SCHEMA_INCOMING_FIELD(kind, name) SCHEMA_INCOMING_TYPE_##kind name;
+#define SCHEMA_OUTGOING_FIELD(kind, name) SCHEMA_OUTGOING_TYPE_##kind name;
+
+#define SCHEMA_INCOMING_DECLARE(name, header, fields) \
+    typedef struct name##_packet_s { fields(SCHEMA_INCOMING_FIELD) } name##_packet; \
+    bool name##_packet_decode(incoming_message *im, name##_packet *packet);
+
+#define SCHEMA_OUTGOING_DECLARE(name, header, fields) \
+    typedef struct name##_packet_s { fields(SCHEMA_OUTGOING_FIELD) } name##_packet; \
+    int name##_packet_size(const name##_packet *packet); \
+    int name##_packet_encode(const name##_packet *packet, char *buffer); \
+    shared_buffer *name##_packet_build(const name##_packet *packet); \
+    void name##_packet_send(session *player, const name##_packet *packet);
+
+INCOMING_PACKETS(SCHEMA_INCOMING_DECLARE)
+OUTGOING_PACKETS(SCHEMA_OUTGOING_DECLARE)
+
+int packet_string_copy(packet_string *string, char *buffer, size_t size);
+
+#endif
@@ -91,7 +91,7 @@ void room_query_remove_favourite(int room_id, int player_id) {
  * Get list of room favourites by player id.
  *
  * @param player_id the player id to get the favourites for
- * @return the list of rooms
+ * @return the list of rooms, each room is retained and must be released with room_release
  */
 List *room_query_favourites(int player_id) {
     List *favourites;
@@ -116,15 +116,15 @@ List *room_query_favourites(int player_id) {
         }
 
         int room_id = sqlite3_column_int(stmt, 0);
-        room *room = NULL;
+        room *room = room_manager_get_by_id(room_id);
 
-        if (room_manager_get_by_id(room_id) != NULL) {
-            room = room_manager_get_by_id(room_id);
-        } else {
+        if (room == NULL) {
             room = room_query_get_by_room_id(room_id);
         }
 
-        list_add(favourites, room);
+        if (room != NULL) {
+            list_add(favourites, room);
+        }
     }
 
     db_check_finalize(sqlite3_finalize(stmt), conn);
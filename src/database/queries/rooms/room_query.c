@@ -132,7 +132,7 @@ room *room_query_get_by_room_id(int room_id) {
  * Gets all rooms as a list by owner id.
  *
  * @param owner_id the owner id of the rooms
- * @return the list of rooms
+ * @return the list of rooms, each room is retained and must be released with room_release
  */
 List *room_query_get_by_owner_id(int owner_id) {
     List *rooms;
@@ -156,11 +156,9 @@ List *room_query_get_by_owner_id(int owner_id) {
         }
 
         int room_id = sqlite3_column_int(stmt, 0);
-        room *room = NULL;
+        room *room = room_manager_get_by_id(room_id);
 
-        if (room_manager_get_by_id(room_id) != NULL) {
-            room = room_manager_get_by_id(room_id);
-        } else {
+        if (room == NULL) {
             room = room_create(sqlite3_column_int(stmt, 0));
             room->room_data = room_create_data_sqlite(room, stmt);
         }
@@ -177,7 +175,7 @@ List *room_query_get_by_owner_id(int owner_id) {
  * Gets all rooms through search either by the owner name sounding familiar or the room name.
  *
  * @param search_query the search query
- * @return the list of rooms found
+ * @return the list of rooms found, each room is retained and must be released with room_release
  */
 List *room_query_search(char *search_query) {
     List *rooms;
@@ -209,11 +207,9 @@ List *room_query_search(char *search_query) {
         }
 
         int room_id = sqlite3_column_int(stmt, 0);
-        room *room = NULL;
+        room *room = room_manager_get_by_id(room_id);
 
-        if (room_manager_get_by_id(room_id) != NULL) {
-            room = room_manager_get_by_id(room_id);
-        } else {
+        if (room == NULL) {
             room = room_create(sqlite3_column_int(stmt, 0));
             room->room_data = room_create_data_sqlite(room, stmt);
         }
@@ -230,7 +226,7 @@ List *room_query_search(char *search_query) {
  * Gets recently created rooms within a given catgeory, and the limit of rooms to select.
  *
  * @param limit the limit of rows to select
- * @return the list of recently created rooms
+ * @return the list of recently created rooms, each room is retained and must be released with room_release
  */
 List *room_query_recent_rooms(int limit, int category_id) {
     List *rooms;
@@ -255,11 +251,9 @@ List *room_query_recent_rooms(int limit, int category_id) {
         }
 
         int room_id = sqlite3_column_int(stmt, 0);
-        room *room = NULL;
+        room *room = room_manager_get_by_id(room_id);
 
-        if (room_manager_get_by_id(room_id) != NULL) {
-            room = room_manager_get_by_id(room_id);
-        } else {
+        if (room == NULL) {
             room = room_create(sqlite3_column_int(stmt, 0));
             room->room_data = room_create_data_sqlite(room, stmt);
         }
@@ -276,7 +270,7 @@ List *room_query_recent_rooms(int limit, int category_id) {
  * Get random rooms, this doesn't include public rooms.
  *
  * @param limit the limit of random rooms to select.
- * @return the list of random rooms
+ * @return the list of random rooms, each room is retained and must be released with room_release
  */
 List *room_query_random_rooms(int limit) {
     List *rooms;
@@ -301,11 +295,9 @@ List *room_query_random_rooms(int limit) {
         }
 
         int room_id = sqlite3_column_int(stmt, 0);
-        room *room = NULL;
+        room *room = room_manager_get_by_id(room_id);
 
-        if (room_manager_get_by_id(room_id) != NULL) {
-            room = room_manager_get_by_id(room_id);
-        } else {
+        if (room == NULL) {
             room = room_create(sqlite3_column_int(stmt, 0));
             room->room_data = room_create_data_sqlite(room, stmt);
         }
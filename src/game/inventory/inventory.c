@@ -40,17 +40,15 @@ void inventory_init(session *player) {
     player->inventory->items = item_query_get_inventory(player->player_data->id);
 }
 
-void inventory_send(inventory *inv, char *strip_view, session *player) {
+void inventory_send(inventory *inv, const char *strip_view, session *player) {
     inventory_change_view(inv, strip_view);
-    char *item_casts = inventory_get_casts(inv);
 
     outgoing_message *om = om_create(140); // "BL"
-    sb_add_string_delimeter(om->sb, item_casts, 13);
+    inventory_append_casts(inv, om->sb);
+    sb_add_char(om->sb, 13);
     sb_add_int(om->sb, (int) list_size(inv->items));
     player_send(player, om);
     om_cleanup(om);
-
-    free(item_casts);
 }
 
 /**
@@ -79,7 +77,7 @@ item *inventory_get_item(inventory *inventory, int item_id) {
  * @param inventory the inventory to change
  * @param strip_view the view type to change to
  */
-void inventory_change_view(inventory *inventory, char *strip_view) {
+void inventory_change_view(inventory *inventory, const char *strip_view) {
     if (strcmp(strip_view, "new") == 0) {
         inventory->hand_strip_page_index = 0;
     }
@@ -104,10 +102,9 @@ void inventory_change_view(inventory *inventory, char *strip_view) {
  * Credits to Woodpecker v3 for this, thanks Nillus yet again. <3
  *
  * @param inventory the inventory to get the casts for
+ * @param sb the stringbuilder to append to
  */
-char *inventory_get_casts(inventory *inventory) {
-    stringbuilder *sb = sb_create();
-
+void inventory_append_casts(inventory *inventory, stringbuilder *sb) {
     int start_id = 0;
     int end_id = (int) list_size(inventory->items);
 
@@ -132,28 +129,19 @@ char *inventory_get_casts(inventory *inventory) {
             item *item;
             list_get_at(inventory->items, (size_t) strip_slot_id, (void*)&item);
 
-            char *strip_string = item_strip_string(item, strip_slot_id);
-            sb_add_string(sb, strip_string);
-            free(strip_string);
+            item_append_strip_string(item, strip_slot_id, sb);
         }
     }
-
-    char *str = strdup(sb->data);
-    sb_cleanup(sb);
-
-    return str;
 }
 
 /**
- * Get the string used for packets to append for the hand.
+ * Append the string used for packets for the hand.
  *
  * @param item the item to append
  * @param strip_slot_id it's strip slot id
- * @return the string to append
+ * @param sb the stringbuilder to append to
  */
-char *item_strip_string(item *item, int strip_slot_id) {
-    stringbuilder *sb = sb_create();
-
+void item_append_strip_string(item *item, int strip_slot_id, stringbuilder *sb) {
     sb_add_string_delimeter(sb, "SI", 30);
     sb_add_int_delimeter(sb, item->id, 30);
     sb_add_int_delimeter(sb, strip_slot_id, 30);
@@ -179,12 +167,7 @@ char *item_strip_string(item *item, int strip_slot_id) {
         sb_add_string_delimeter(sb, item->definition->sprite, 30);
     }
 
-    sb_add_string(sb, "/");
-
-    char *str = strdup(sb->data);
-    sb_cleanup(sb);
-
-    return str;
+    sb_add_char(sb, '/');
 }
 
 /**
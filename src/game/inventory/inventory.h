@@ -4,6 +4,7 @@
 typedef struct list_s List;
 typedef struct item_s item;
 typedef struct session_s session;
+typedef struct stringbuilder_s stringbuilder;
 
 typedef struct inventory_s {
     List *items;
@@ -12,11 +13,11 @@ typedef struct inventory_s {
 
 inventory *inventory_create();
 void inventory_init(session *player);
-void inventory_send(inventory *inventory, char *strip_view, session *player);
+void inventory_send(inventory *inventory, const char *strip_view, session *player);
 item *inventory_get_item(inventory *inventory, int item_id);
-void inventory_change_view(inventory *inventory, char *strip_view);
-char *inventory_get_casts(inventory*);
-char *item_strip_string(item *item, int strip_slot_id);
+void inventory_change_view(inventory *inventory, const char *strip_view);
+void inventory_append_casts(inventory*, stringbuilder*);
+void item_append_strip_string(item *item, int strip_slot_id, stringbuilder *sb);
 void inventory_dispose(inventory *inventory);
 
 #endif
\ No newline at end of file
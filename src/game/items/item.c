@@ -128,6 +128,14 @@ void item_set_custom_data(item *item, char *custom_data) {
     }
 
     item->custom_data = custom_data;
+
+    // Doors open and close through their custom data
+    room *room = room_manager_get_by_id(item->room_id);
+
+    if (room != NULL) {
+        room_map_refresh_item(room, item);
+        room_release(room);
+    }
 }
 
 void item_broadcast_custom_data(item* item, char *custom_data) {
@@ -135,9 +143,7 @@ void item_broadcast_custom_data(item* item, char *custom_data) {
 
     if (item->definition->behaviour->is_wall_item) {
         om = om_create(85); // "AU"
-        char *item_string = item_as_string(item);
-        sb_add_string(om->sb, item_string);
-        free(item_string);
+        item_append_string(item, om->sb);
     } else {
         om = om_create(88); // "AX"
         sb_add_int_delimeter(om->sb, item->id, 2);
@@ -149,6 +155,7 @@ void item_broadcast_custom_data(item* item, char *custom_data) {
 
     if (room != NULL) {
         room_send(room, om);
+        room_release(room);
     }
 
     om_cleanup(om);
@@ -181,15 +188,12 @@ bool item_is_walkable(item *item) {
 }
 
 /**
- * Get the item represented as a string for various item packets.
- * Must be free'd after use.
+ * Append the item represented as a string for various item packets.
  *
  * @param item the item to get the string for
- * @return the string representation of the time.
+ * @param sb the stringbuilder to append to, usually the one of the packet
  */
-char *item_as_string(item *item) {
-    stringbuilder *sb = sb_create();
-
+void item_append_string(item *item, stringbuilder *sb) {
     if (item->definition->behaviour->is_wall_item) {
         sb_add_int_delimeter(sb, item->id, 9);
         sb_add_string_delimeter(sb, item->definition->sprite, 9);
@@ -212,11 +216,15 @@ char *item_as_string(item *item) {
         if (!item->definition->behaviour->is_public_space_object) {
             sb_add_int_delimeter(sb, item->id, 2);
             sb_add_string_delimeter(sb, item->definition->sprite, 2);
-            sb_add_wired(sb, item->position->x);
-            sb_add_wired(sb, item->position->y);
-            sb_add_wired(sb, item->definition->length);
-            sb_add_wired(sb, item->definition->width);
-            sb_add_wired(sb, item->position->rotation);
+            int dimensions[] = {
+                item->position->x,
+                item->position->y,
+                item->definition->length,
+                item->definition->width,
+                item->position->rotation
+            };
+
+            sb_add_wired_many(sb, dimensions, 5);
             sb_add_float_delimeter(sb, item->position->z, 2);
             sb_add_string_delimeter(sb, item->definition->colour, 2);
             sb_add_string_delimeter(sb, "", 2);
@@ -237,11 +245,6 @@ char *item_as_string(item *item) {
             sb_add_char(sb, 13);
         }
     }
-
-    char *str = strdup(sb->data);
-    sb_cleanup(sb);
-
-    return str;
 }
 
 
@@ -272,6 +275,9 @@ void item_assign_program(item *room_item, char *program_state) {
 
             room_send(room, om);
             om_cleanup(om);
+
+            room_map_refresh_item(room, room_item);
+            room_release(room);
         }
 
     } else {
@@ -314,10 +320,12 @@ void item_dispose(item *item) {
 
     room *room = room_manager_get_by_id(item->room_id);
 
-    if (room != NULL && item->room_id > 0) {
-        if (list_size(room->room_data->model_data->public_items) > 0) {
+    if (room != NULL) {
+        if (item->room_id > 0 && list_size(room->room_data->model_data->public_items) > 0) {
             item_definition_dispose(item->definition); // Destroy if public item since every public item has their own definition
         }
+
+        room_release(room);
     }
 
     free(item);
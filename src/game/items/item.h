@@ -3,9 +3,12 @@
 
 #include <shared.h>
 
+#define ITEM_STRING_ESTIMATE 64
+
 typedef struct room_s room;
 typedef struct coord_s coord;
 typedef struct item_definition_s item_definition;
+typedef struct stringbuilder_s stringbuilder;
 
 typedef struct item_s {
     int id;
@@ -24,8 +27,7 @@ void item_update_entities(item *item, room *room, coord *old_position);
 void item_set_custom_data(item *item, char *custom_data);
 void item_broadcast_custom_data(item* item, char *custom_data);
 bool item_is_walkable(item *item);
-char *item_as_string(item *item);
-char *item_strip_string(item *item, int strip_slot_id);
+void item_append_string(item *item, stringbuilder *sb);
 void item_assign_program(item*, char*);
 double item_total_height(item *item);
 void item_dispose(item *item);
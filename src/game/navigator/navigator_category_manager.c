@@ -116,7 +116,8 @@ List *category_manager_get_by_parent_id(int category_id) {
 }
 
 /**
- * Get rooms by the category id.
+ * Get rooms by the category id, every room in the list is retained and must be
+ * released with room_release.
  * 
  * @param category_id the category id
  * @return the list of rooms
@@ -125,6 +126,8 @@ List *category_manager_get_rooms(int category_id) {
     List *rooms;
     list_new(&rooms);
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     HashTableIter iter;
     hashtable_iter_init(&iter, global.room_manager.rooms);
 
@@ -133,21 +136,27 @@ List *category_manager_get_rooms(int category_id) {
         room *instance = entry->value;
 
         if (instance->room_data->category == category_id) {
+            room_retain(instance);
             list_add(rooms, instance);
         }
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
     return rooms;
 }
 
 /**
+ * Get the amount of visitors in a category and every category underneath it, the
+ * visitor counts are the ones published by each room's actor.
  *
- * @param category_id
- * @return
+ * @param category_id the category id
+ * @return the current visitors
  */
 int category_manager_get_current_vistors(int category_id) {
     int current_visitors = 0;
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     HashTableIter iter;
     hashtable_iter_init(&iter, global.room_manager.rooms);
 
@@ -156,37 +165,41 @@ int category_manager_get_current_vistors(int category_id) {
         room *instance = entry->value;
 
         if (instance->room_data->category == category_id) {
-            current_visitors += instance->room_data->visitors_now;
+            current_visitors += atomic_load(&instance->room_data->visitors_now);
+        }
+    }
 
-            /**
-             * Recursive lisiting for child categories underneath this category
-             */
-            List *categories = category_manager_get_by_parent_id(category_id);
+    pthread_mutex_unlock(&global.room_manager.lock);
 
-            ListIter list_iter;
-            list_iter_init(&list_iter, categories);
+    /**
+     * Recursive lisiting for child categories underneath this category
+     */
+    List *categories = category_manager_get_by_parent_id(category_id);
 
-            room_category *category;
+    ListIter list_iter;
+    list_iter_init(&list_iter, categories);
 
-            while (list_iter_next(&list_iter, (void*) &category) != CC_ITER_END) {
-                current_visitors += category_manager_get_current_vistors(category->id);
-            }
+    room_category *category;
 
-            list_destroy(categories);
-        }
+    while (list_iter_next(&list_iter, (void*) &category) != CC_ITER_END) {
+        current_visitors += category_manager_get_current_vistors(category->id);
     }
 
+    list_destroy(categories);
     return current_visitors;
 }
 
 /**
+ * Get the maximum amount of visitors in a category and every category underneath it.
  *
- * @param category_id
- * @return
+ * @param category_id the category id
+ * @return the max visitors
  */
 int category_manager_get_max_vistors(int category_id) {
     int max_visitors = 0;
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     HashTableIter iter;
     hashtable_iter_init(&iter, global.room_manager.rooms);
 
@@ -196,24 +209,26 @@ int category_manager_get_max_vistors(int category_id) {
 
         if (instance->room_data->category == category_id) {
             max_visitors += instance->room_data->visitors_max;
+        }
+    }
 
-            /**
-             * Recursive lisiting for child categories underneath this category
-             */
-            List *categories = category_manager_get_by_parent_id(category_id);
+    pthread_mutex_unlock(&global.room_manager.lock);
 
-            ListIter list_iter;
-            list_iter_init(&list_iter, categories);
+    /**
+     * Recursive lisiting for child categories underneath this category
+     */
+    List *categories = category_manager_get_by_parent_id(category_id);
 
-            room_category *category;
+    ListIter list_iter;
+    list_iter_init(&list_iter, categories);
 
-            while (list_iter_next(&list_iter, (void*) &category) != CC_ITER_END) {
-                max_visitors += category_manager_get_max_vistors(category->id);
-            }
-            list_destroy(categories);
-        }
+    room_category *category;
+
+    while (list_iter_next(&list_iter, (void*) &category) != CC_ITER_END) {
+        max_visitors += category_manager_get_max_vistors(category->id);
     }
 
+    list_destroy(categories);
     return max_visitors;
 }
 
@@ -0,0 +1,125 @@
+#include <stdlib.h>
+
+#include "deque.h"
+
+#include "path_cache.h"
+#include "pathfinder.h"
+#include "coord.h"
+
+#include "game/room/mapping/room_map.h"
+
+/**
+ * Create an empty path cache, each room map has one.
+ *
+ * @return the path cache
+ */
+path_cache *path_cache_create() {
+    return calloc(1, sizeof(path_cache));
+}
+
+/**
+ * Find the entry for a walk, users who differ in what they can walk on never share paths.
+ */
+static path_cache_entry *path_cache_find(path_cache *cache, const pathfinder_walker *walker, int goal, unsigned int layout_version) {
+    for (int i = 0; i < cache->count; i++) {
+        path_cache_entry *entry = &cache->entries[i];
+
+        if (entry->start == walker->start &&
+            entry->goal == goal &&
+            entry->layout_version == layout_version &&
+            entry->has_pool_figure == walker->has_pool_figure &&
+            entry->has_tickets == walker->has_tickets) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Get a copy of the path found before for the same walk, while the layout of the room
+ * hasn't changed since.
+ *
+ * @param cache the path cache
+ * @param walker the walker
+ * @param goal the tile index of the goal
+ * @param layout_version the current layout version of the room map
+ * @return the tiles to walk over, NULL if the walk isn't cached
+ */
+Deque *path_cache_get(path_cache *cache, const pathfinder_walker *walker, int goal, unsigned int layout_version) {
+    path_cache_entry *entry = path_cache_find(cache, walker, goal, layout_version);
+
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    entry->used = ++cache->clock;
+
+    Deque *path;
+    deque_new(&path);
+
+    for (int i = 0; i < entry->length; i++) {
+        int tile = entry->tiles[i];
+        deque_add_last(path, create_coord(tile / walker->grid->size_y, tile % walker->grid->size_y));
+    }
+
+    return path;
+}
+
+/**
+ * Remember the path of a walk, replacing the walk that was used longest ago when full.
+ *
+ * @param cache the path cache
+ * @param walker the walker the path was searched for
+ * @param goal the tile index of the goal
+ * @param layout_version the layout version of the room map the path was searched on
+ * @param path the tiles to walk over, left as it is
+ */
+void path_cache_put(path_cache *cache, const pathfinder_walker *walker, int goal, unsigned int layout_version, Deque *path) {
+    path_cache_entry *entry = path_cache_find(cache, walker, goal, layout_version);
+
+    if (entry == NULL) {
+        if (cache->count < PATH_CACHE_ENTRIES) {
+            entry = &cache->entries[cache->count++];
+        } else {
+            entry = &cache->entries[0];
+
+            for (int i = 1; i < cache->count; i++) {
+                if (cache->entries[i].used < entry->used) {
+                    entry = &cache->entries[i];
+                }
+            }
+        }
+
+        free(entry->tiles);
+
+        entry->start = walker->start;
+        entry->goal = goal;
+        entry->layout_version = layout_version;
+        entry->has_pool_figure = walker->has_pool_figure;
+        entry->has_tickets = walker->has_tickets;
+        entry->length = (int) deque_size(path);
+        entry->tiles = malloc(sizeof(int) * (size_t) (entry->length > 0 ? entry->length : 1));
+
+        for (int i = 0; i < entry->length; i++) {
+            coord *step;
+            deque_get_at(path, (size_t) i, (void *) &step);
+            entry->tiles[i] = ROOM_GRID_INDEX(walker->grid, step->x, step->y);
+        }
+    }
+
+    entry->used = ++cache->clock;
+}
+
+/**
+ * Free the path cache and every path in it.
+ *
+ * @param cache the path cache
+ */
+void path_cache_dispose(path_cache *cache) {
+    for (int i = 0; i < cache->count; i++) {
+        free(cache->entries[i].tiles);
+    }
+
+    free(cache);
+}
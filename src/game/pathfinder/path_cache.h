@@ -0,0 +1,33 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <stdbool.h>
+
+#define PATH_CACHE_ENTRIES 16
+
+typedef struct deque_s Deque;
+typedef struct pathfinder_walker_s pathfinder_walker;
+
+typedef struct path_cache_entry_s {
+    int start;
+    int goal;
+    unsigned int layout_version; // see room_map.layout_version
+    bool has_pool_figure;
+    bool has_tickets;
+    int *tiles; // tile indexes of the path, excluding the start
+    int length;
+    unsigned long used; // the cache clock when the entry was last used, the oldest is replaced
+} path_cache_entry;
+
+typedef struct path_cache_s {
+    path_cache_entry entries[PATH_CACHE_ENTRIES];
+    int count;
+    unsigned long clock;
+} path_cache;
+
+path_cache *path_cache_create();
+Deque *path_cache_get(path_cache *cache, const pathfinder_walker *walker, int goal, unsigned int layout_version);
+void path_cache_put(path_cache *cache, const pathfinder_walker *walker, int goal, unsigned int layout_version, Deque *path);
+void path_cache_dispose(path_cache *cache);
+
+#endif
@@ -0,0 +1,240 @@
+#include <stdlib.h>
+
+#include "shared.h"
+#include "deque.h"
+
+#include "path_request.h"
+#include "path_cache.h"
+#include "coord.h"
+
+#include "game/room/room.h"
+#include "game/room/room_user.h"
+#include "game/room/mapping/room_map.h"
+#include "game/room/mapping/room_tile.h"
+
+#include "util/executor.h"
+
+static void path_request_run(path_request *request);
+static void path_request_release(path_request *request);
+
+/**
+ * Search a path for the room user to its goal on a worker thread, the room actor goes on
+ * meanwhile and the walk task picks up the path with path_request_apply. A path the user
+ * asked for before is superseded, if its search hasn't started yet it won't be done at all.
+ * Walks the room saw before since its layout last changed are taken from its path cache.
+ * A user halfway a step is searched for from the tile it's stepping onto.
+ *
+ * @param room_user the room user, its goal set
+ */
+void path_request_submit(room_user *room_user) {
+    path_request_cancel(room_user);
+
+    room *room = room_user->room;
+    room_map *map = room->room_map;
+    room_grid *grid = &map->grid;
+    coord *start = room_user->next != NULL ? room_user->next : room_user->position;
+
+    if (start->x < 0 || start->x >= grid->size_x ||
+        start->y < 0 || start->y >= grid->size_y ||
+        room_user->goal->x < 0 || room_user->goal->x >= grid->size_x ||
+        room_user->goal->y < 0 || room_user->goal->y >= grid->size_y) {
+        return;
+    }
+
+    path_request *request = malloc(sizeof(path_request));
+    atomic_init(&request->superseded, false);
+    request->grid = NULL;
+    request->goal = ROOM_GRID_INDEX(grid, room_user->goal->x, room_user->goal->y);
+    request->layout_version = map->layout_version;
+    request->path = NULL;
+
+    pathfinder_walker_init(&request->walker, room_user, grid);
+    request->walker.start = ROOM_GRID_INDEX(grid, start->x, start->y);
+    room_user->path_request = request;
+
+    request->path = path_cache_get(map->path_cache, &request->walker, request->goal, map->layout_version);
+    request->cached = request->path != NULL;
+
+    if (request->cached) {
+        atomic_init(&request->references, 1);
+        atomic_init(&request->done, true);
+        return;
+    }
+
+    atomic_init(&request->references, 2);
+    atomic_init(&request->done, false);
+
+    request->grid = room_map_snapshot(room);
+    request->walker.grid = request->grid;
+
+    executor_submit(global.thread_manager.executor, (executor_task) path_request_run, request);
+}
+
+/**
+ * Take over the path the room user asked for, if its search finished. Called by the walk task
+ * before moving the user, the path goes on from the tile the user stands on or is stepping onto.
+ * When the user ended up elsewhere in the meantime the search is done again from there.
+ *
+ * @param room_user the room user
+ */
+void path_request_apply(room_user *room_user) {
+    path_request *request = room_user->path_request;
+
+    if (request == NULL || !atomic_load_explicit(&request->done, memory_order_acquire)) {
+        return;
+    }
+
+    room_user->path_request = NULL;
+    room_map *map = room_user->room->room_map;
+    coord *start = room_user->next != NULL ? room_user->next : room_user->position;
+
+    if (request->walker.start != ROOM_GRID_INDEX(&map->grid, start->x, start->y)) {
+        path_request_release(request);
+        path_request_submit(room_user);
+        return;
+    }
+
+    if (request->path != NULL && deque_size(request->path) > 0) {
+        if (!request->cached && request->layout_version == map->layout_version) {
+            path_cache_put(map->path_cache, &request->walker, request->goal, request->layout_version, request->path);
+        }
+
+        // Swap the walk list only, a step the user is taking is finished first
+        Deque *walk_list = room_user->walk_list;
+        room_user->walk_list = request->path;
+        room_user->is_walking = true;
+        request->path = walk_list;
+    }
+
+    path_request_release(request);
+}
+
+/**
+ * Drop the path the room user asked for, if there's one.
+ *
+ * @param room_user the room user
+ */
+void path_request_cancel(room_user *room_user) {
+    path_request *request = room_user->path_request;
+
+    if (request == NULL) {
+        return;
+    }
+
+    room_user->path_request = NULL;
+
+    atomic_store_explicit(&request->superseded, true, memory_order_relaxed);
+    path_request_release(request);
+}
+
+/**
+ * Walk around a tile on the path that got blocked, the tile was taken off the walk list already.
+ * A short search finds a way to the first free tile of the rest of the path and the tiles up to
+ * there are swapped for it, so users bumping into each other don't search their whole path again.
+ *
+ * @param room_user the room user
+ * @return true, if the walk list was repaired, false if a full search is needed
+ */
+bool path_request_repair(room_user *room_user) {
+    room *room = room_user->room;
+    room_grid *grid = &room->room_map->grid;
+    Deque *walk_list = room_user->walk_list;
+
+    size_t rejoin = 0;
+    coord *target = NULL;
+
+    for (size_t i = 0; i < deque_size(walk_list) && i < PATH_REPAIR_WINDOW; i++) {
+        coord *step;
+        deque_get_at(walk_list, i, (void *) &step);
+
+        if (!room_tile_is_walkable(room, room_user, step->x, step->y)) {
+            continue;
+        }
+
+        // The search ends on the tile as if it were the goal, only join on tiles that are fine to walk over
+        uint8_t flags = grid->flags[ROOM_GRID_INDEX(grid, step->x, step->y)];
+
+        if (i + 1 < deque_size(walk_list) && (flags & ROOM_TILE_HAS_ITEM) && !(flags & ROOM_TILE_ITEM_STANDABLE)) {
+            continue;
+        }
+
+        rejoin = i;
+        target = step;
+        break;
+    }
+
+    if (target == NULL) {
+        return false;
+    }
+
+    pathfinder_walker walker;
+    pathfinder_walker_init(&walker, room_user, grid);
+
+    pathfinder *p = pathfinder_for_thread(grid->size_x, grid->size_y);
+    Deque *detour = pathfinder_create_path(p, &walker, ROOM_GRID_INDEX(grid, target->x, target->y), PATH_REPAIR_EXPANSIONS);
+
+    if (deque_size(detour) == 0) {
+        deque_destroy(detour);
+        return false;
+    }
+
+    // The detour ends on the tile it joins, drop everything up to and including that tile
+    for (size_t i = 0; i <= rejoin; i++) {
+        coord *step;
+        deque_remove_first(walk_list, (void *) &step);
+        free(step);
+    }
+
+    while (deque_size(detour) > 0) {
+        coord *step;
+        deque_remove_last(detour, (void *) &step);
+        deque_add_first(walk_list, step);
+    }
+
+    deque_destroy(detour);
+    return true;
+}
+
+/**
+ * Search the path on a worker, against the snapshot only.
+ *
+ * @param request the request
+ */
+static void path_request_run(path_request *request) {
+    if (!atomic_load_explicit(&request->superseded, memory_order_relaxed)) {
+        const room_grid *grid = request->grid;
+        pathfinder *p = pathfinder_for_thread(grid->size_x, grid->size_y);
+
+        request->path = pathfinder_create_path(p, &request->walker, request->goal, 0);
+    }
+
+    atomic_store_explicit(&request->done, true, memory_order_release);
+    path_request_release(request);
+}
+
+/**
+ * Drop a reference to the request, the last one frees it along with a path nobody took.
+ *
+ * @param request the request
+ */
+static void path_request_release(path_request *request) {
+    if (atomic_fetch_sub(&request->references, 1) != 1) {
+        return;
+    }
+
+    if (request->path != NULL) {
+        while (deque_size(request->path) > 0) {
+            coord *step;
+            deque_remove_first(request->path, (void *) &step);
+            free(step);
+        }
+
+        deque_destroy(request->path);
+    }
+
+    if (request->grid != NULL) {
+        room_grid_release(request->grid);
+    }
+
+    free(request);
+}
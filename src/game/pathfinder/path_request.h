@@ -0,0 +1,33 @@
+#ifndef PATH_REQUEST_H
+#define PATH_REQUEST_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "pathfinder.h"
+
+#define PATH_REPAIR_WINDOW 6 // how far along the rest of the path a detour may join it again
+#define PATH_REPAIR_EXPANSIONS 64 // the nodes a detour may expand before a full search is done instead
+
+typedef struct deque_s Deque;
+typedef struct room_user_s room_user;
+typedef struct room_grid_s room_grid;
+
+typedef struct path_request_s {
+    atomic_int references; // the room user until it takes the path, and the search job
+    atomic_bool superseded; // the user asked for another path or stopped, don't bother searching
+    atomic_bool done;
+    room_grid *grid; // snapshot of the room map taken when the path was asked for, NULL when cached
+    unsigned int layout_version; // see room_map.layout_version
+    bool cached; // the path came from the path cache of the room, it's done straight away
+    pathfinder_walker walker;
+    int goal;
+    Deque *path; // the result, only read by the room once done is set
+} path_request;
+
+void path_request_submit(room_user *room_user);
+void path_request_apply(room_user *room_user);
+void path_request_cancel(room_user *room_user);
+bool path_request_repair(room_user *room_user);
+
+#endif
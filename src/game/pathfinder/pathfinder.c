@@ -3,23 +3,21 @@
 #include "string.h"
 
 #include "pathfinder.h"
-#include "node.h"
 #include "coord.h"
 
 #include "deque.h"
 
 #include "game/player/player.h"
-#include "game/items/item.h"
 
 #include "game/room/room.h"
 #include "game/room/room_user.h"
 
 #include "game/room/mapping/room_model.h"
 #include "game/room/mapping/room_map.h"
-#include "game/room/mapping/room_tile.h"
 
-#include <limits.h>
-#include <game/items/definition/item_definition.h>
+
+// Every search of a thread reuses its arena, it only grows when a bigger model is searched
+static _Thread_local pathfinder *thread_pathfinder = NULL;
 
 coord DIAGONAL_MOVE_POINTS[] = {
     { 0, -1, 0 },
@@ -33,233 +31,604 @@ coord DIAGONAL_MOVE_POINTS[] = {
 };
 
 /**
+ * Find the path from the room user's position to its goal.
  *
- * @param room_user
- * @return
+ * @param room_user the room user
+ * @return the tiles to walk over, excluding the current position, empty if there's no path
  */
 Deque *create_path(room_user *room_user) {
     if (room_user->room == NULL) {
         return NULL;
     }
 
+    room *user_room = (void *)room_user->room;
+    room_grid *grid = &user_room->room_map->grid;
+
+    if (room_user->position->x < 0 || room_user->position->x >= grid->size_x ||
+        room_user->position->y < 0 || room_user->position->y >= grid->size_y ||
+        room_user->goal->x < 0 || room_user->goal->x >= grid->size_x ||
+        room_user->goal->y < 0 || room_user->goal->y >= grid->size_y) {
+        Deque *path;
+        deque_new(&path);
+        return path;
+    }
+
+    pathfinder_walker walker;
+    pathfinder_walker_init(&walker, room_user, grid);
+
+    pathfinder *pathfinder = pathfinder_for_thread(grid->size_x, grid->size_y);
+    return pathfinder_create_path(pathfinder, &walker, ROOM_GRID_INDEX(grid, room_user->goal->x, room_user->goal->y), 0);
+}
+
+/**
+ * Search the path of a walker and list its tiles.
+ *
+ * @param p the pathfinder, from pathfinder_for_thread
+ * @param walker the walker
+ * @param goal the tile index of the goal
+ * @param max_expanded the nodes to expand before giving up, 0 for no limit
+ * @return the tiles to walk over, excluding the start, empty if there's no path
+ */
+Deque *pathfinder_create_path(pathfinder *p, const pathfinder_walker *walker, int goal, int max_expanded) {
+    const room_grid *grid = walker->grid;
+
     Deque *path;
     deque_new(&path);
 
-    room *user_room = (void *)room_user->room;
-    int map_size_x = user_room->room_data->model_data->map_size_x;
-    int map_size_y = user_room->room_data->model_data->map_size_y;
+    int current = pathfinder_search(p, walker, goal, grid->jump_point_search, max_expanded);
 
-    pathfinder *pathfinder = NULL;
-    pathfinder = make_path_reversed(room_user, map_size_x, map_size_y);
+    // Walk back from the goal, the start itself isn't part of the path. Jump point search
+    // only links the turning points, so the tiles in between are filled in here
+    while (current != -1 && p->nodes[current].parent != -1) {
+        int parent = p->nodes[current].parent;
 
-    if (pathfinder->nodes != NULL) {
-        while (pathfinder->nodes->node != NULL) {
-            int x = pathfinder->nodes->x;
-            int y = pathfinder->nodes->y;
+        int x = current / grid->size_y;
+        int y = current % grid->size_y;
+        int parent_x = parent / grid->size_y;
+        int parent_y = parent % grid->size_y;
 
-            if (!pathfinder->failed) {
-                deque_add_first(path, create_coord(x, y));
-            }
-            
-            pathfinder->nodes = (void *)pathfinder->nodes->node;
+        while (x != parent_x || y != parent_y) {
+            deque_add_first(path, create_coord(x, y));
+            x += (parent_x > x) - (parent_x < x);
+            y += (parent_y > y) - (parent_y < y);
         }
 
-        for (int x = 0; x < map_size_x; x++) {
-            for (int y = 0; y < map_size_y; y++) {
-                node *node = pathfinder->map[x][y];
-                if (node != NULL) {
-                    free(node);
-                    pathfinder->map[x][y] = NULL;
-                }
-            }
-        }
+        current = parent;
     }
 
-    deque_destroy(pathfinder->open_list);
-    free(pathfinder);
-    
     return path;
 }
 
 /**
+ * Get the pathfinder arena of the calling thread, sized for the given model. Every call
+ * starts a new search generation, so nodes of earlier searches count as unvisited
+ * without having to clear them.
+ *
+ * @param map_size_x the width of the model
+ * @param map_size_y the length of the model
+ * @return the pathfinder
+ */
+pathfinder *pathfinder_for_thread(int map_size_x, int map_size_y) {
+    pathfinder *p = thread_pathfinder;
+    int tiles = map_size_x * map_size_y;
+
+    if (p == NULL) {
+        p = calloc(1, sizeof(pathfinder));
+        thread_pathfinder = p;
+    }
+
+    if (p->capacity < tiles) {
+        free(p->nodes);
+        free(p->open_heap);
+
+        p->nodes = calloc((size_t) tiles, sizeof(pathfinder_node));
+        p->open_heap = malloc(sizeof(int) * tiles);
+        p->capacity = tiles;
+        p->generation = 0;
+    }
+
+    p->map_size_x = map_size_x;
+    p->map_size_y = map_size_y;
+    p->open_count = 0;
+    p->expanded = 0;
+    p->generation++;
+
+    // Wrapped around, nodes from long ago could pass for nodes of this search
+    if (p->generation == 0) {
+        memset(p->nodes, 0, sizeof(pathfinder_node) * p->capacity);
+        p->generation = 1;
+    }
+
+    return p;
+}
+
+/**
+ * Check if a node should be expanded before another one, lowest estimate first. Ties go to the
+ * node furthest along, which is the one closest to the goal.
+ */
+static bool pathfinder_before(pathfinder *p, int first, int second) {
+    pathfinder_node *a = &p->nodes[first];
+    pathfinder_node *b = &p->nodes[second];
+
+    if (a->estimate != b->estimate) {
+        return a->estimate < b->estimate;
+    }
+
+    return a->cost > b->cost;
+}
+
+static void pathfinder_heap_set(pathfinder *p, int position, int index) {
+    p->open_heap[position] = index;
+    p->nodes[index].heap_index = position;
+}
+
+static void pathfinder_sift_up(pathfinder *p, int position) {
+    int index = p->open_heap[position];
+
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+
+        if (!pathfinder_before(p, index, p->open_heap[parent])) {
+            break;
+        }
+
+        pathfinder_heap_set(p, position, p->open_heap[parent]);
+        position = parent;
+    }
+
+    pathfinder_heap_set(p, position, index);
+}
+
+static void pathfinder_sift_down(pathfinder *p, int position) {
+    int index = p->open_heap[position];
+
+    while (true) {
+        int child = position * 2 + 1;
+
+        if (child >= p->open_count) {
+            break;
+        }
+
+        if (child + 1 < p->open_count && pathfinder_before(p, p->open_heap[child + 1], p->open_heap[child])) {
+            child++;
+        }
+
+        if (!pathfinder_before(p, p->open_heap[child], index)) {
+            break;
+        }
+
+        pathfinder_heap_set(p, position, p->open_heap[child]);
+        position = child;
+    }
+
+    pathfinder_heap_set(p, position, index);
+}
+
+static void pathfinder_push(pathfinder *p, int index) {
+    p->open_heap[p->open_count] = index;
+    pathfinder_sift_up(p, p->open_count++);
+}
+
+static int pathfinder_pop(pathfinder *p) {
+    int index = p->open_heap[0];
+    p->open_count--;
+
+    if (p->open_count > 0) {
+        p->open_heap[0] = p->open_heap[p->open_count];
+        pathfinder_sift_down(p, 0);
+    }
+
+    p->nodes[index].heap_index = PATHFINDER_CLOSED;
+    return index;
+}
+
+/**
+ * The octile distance between two tiles, the cheapest a path between them can be.
+ */
+static int pathfinder_distance(int from_x, int from_y, int to_x, int to_y) {
+    int dx = abs(from_x - to_x);
+    int dy = abs(from_y - to_y);
+
+    int diagonal = dx < dy ? dx : dy;
+    int straight = (dx > dy ? dx : dy) - diagonal;
+
+    return diagonal * PATHFINDER_DIAGONAL_COST + straight * PATHFINDER_STRAIGHT_COST;
+}
+
+/**
+ * Resolve everything about the room user the pathfinder needs, so the search itself
+ * only reads the grid.
+ *
+ * @param walker the walker to fill
+ * @param room_user the room user
+ * @param grid the grid of the room map, or a snapshot of it
+ */
+void pathfinder_walker_init(pathfinder_walker *walker, room_user *room_user, const room_grid *grid) {
+    walker->grid = grid;
+    walker->start = ROOM_GRID_INDEX(grid, room_user->position->x, room_user->position->y);
+    walker->has_pool_figure = strlen(room_user->player->player_data->pool_figure) > 0;
+    walker->has_tickets = room_user->player->player_data->tickets > 0;
+}
+
+/**
+ * Get if the walker may stand on a tile, the same rules as room_tile_is_walkable.
  *
- * @param room_user
- * @param from
- * @param to
- * @param is_final_move
- * @return
+ * @param walker the walker
+ * @param index the tile index
+ * @return true, if successful
  */
-int is_valid_tile(room_user *room_user, coord from, coord to, bool is_final_move) {
-    room *room_instance = (void *)room_user->room;
+static bool pathfinder_walkable(const pathfinder_walker *walker, int index) {
+    uint8_t flags = walker->grid->flags[index];
 
-    if (!room_tile_is_walkable(room_instance, room_user, from.x, from.y)) {
+    if (!(flags & ROOM_TILE_OPEN)) {
         return false;
     }
 
-    if (!room_tile_is_walkable(room_instance, room_user, to.x, to.y)) {
+    if (walker->grid->entities_block && (flags & ROOM_TILE_OCCUPIED)) {
+        return index == walker->start;
+    }
+
+    if ((flags & ROOM_TILE_HAS_ITEM) && !(flags & ROOM_TILE_ITEM_WALKABLE)) {
+        return walker->grid->item_origin[index] == walker->start; // Allow player to move out of item if they're stuck
+    }
+
+    return true;
+}
+
+/**
+ * Get if the walker may step from one tile to a neighbouring one.
+ *
+ * @param walker the walker
+ * @param from the tile index to step from
+ * @param to the tile index to step to
+ * @param is_final_move whether the step ends on the goal
+ * @return true, if successful
+ */
+bool is_valid_tile(const pathfinder_walker *walker, int from, int to, bool is_final_move) {
+    const room_grid *grid = walker->grid;
+
+    if (!pathfinder_walkable(walker, from) || !pathfinder_walkable(walker, to)) {
         return false;
     }
 
-    double old_height = room_instance->room_map->map[from.x][from.y]->tile_height;
-    double new_height = room_instance->room_map->map[to.x][to.y]->tile_height;
+    // Can't drop down 4 or climb 1.5 in a single step
+    if (grid->heights[from] - 400 >= grid->heights[to]) {
+        return false;
+    }
 
-    if (old_height - 4 >= new_height) {
-        return 0;
+    if (grid->heights[from] + 150 <= grid->heights[to]) {
+        return false;
     }
 
-    if (old_height + 1.5 <= new_height) {
-        return 0;
+    room_tile_special from_special = grid->special[from];
+    room_tile_special to_special = grid->special[to];
+
+    if (from_special == ROOM_TILE_POOL_ENTRANCE) {
+        return walker->has_pool_figure;
     }
 
-    room_tile *from_tile = room_instance->room_map->map[from.x][from.y];
-    room_tile *to_tile = room_instance->room_map->map[to.x][to.y];
+    bool from_queue = from_special == ROOM_TILE_QUEUE || from_special == ROOM_TILE_QUEUE_START;
+    bool to_queue = to_special == ROOM_TILE_QUEUE || to_special == ROOM_TILE_QUEUE_START;
 
-    item *to_item = to_tile->highest_item;
-    item *from_item = from_tile->highest_item;
+    if (from_queue && to_queue) {
+        return true;
+    }
 
-    if (from_item != NULL) {
-        if (strcmp(from_item->definition->sprite, "poolEnter") == 0 || strcmp(from_item->definition->sprite, "poolExit") == 0) {
-            return strlen(room_user->player->player_data->pool_figure) > 0;
+    if (to_special == ROOM_TILE_POOL_LIFT || to_special == ROOM_TILE_POOL_BOOTH) {
+        if (grid->flags[to] & ROOM_TILE_PROGRAM_CLOSED) {
+            return false;
         }
 
-        if (to_item != NULL) {
-            if (strcmp(room_user->room->room_data->model_data->model_name, "pool_b") == 0
-                && strcmp(from_item->definition->sprite, "queue_tile2") == 0
-                && strcmp(to_item->definition->sprite, "queue_tile2") == 0) {
-                return true;
-            }
+        return to_special == ROOM_TILE_POOL_LIFT ? walker->has_pool_figure : true;
+    }
+
+    if (to_queue) {
+        return to_special == ROOM_TILE_QUEUE_START && walker->has_tickets && walker->has_pool_figure;
+    }
+
+    int from_x = from / grid->size_y;
+    int from_y = from % grid->size_y;
+
+    if (from_x != grid->door_x && from_y != grid->door_y && (grid->flags[to] & ROOM_TILE_HAS_ITEM)) {
+        if (is_final_move) {
+            return (grid->flags[to] & ROOM_TILE_ITEM_WALKABLE) != 0;
+        } else {
+            return (grid->flags[to] & ROOM_TILE_ITEM_STANDABLE) != 0;
         }
     }
 
-    if (to_item != NULL) {
-        if (strcmp(to_item->definition->sprite, "poolLift") == 0 ||
-            strcmp(to_item->definition->sprite, "poolBooth") == 0) {
-            if (to_item->current_program_state != NULL && strcmp(to_item->current_program_state, "close") == 0) {
-                return 0;
-            } else {
-                return strcmp(to_item->definition->sprite, "poolLift") == 0 ?
-                       strlen(room_user->player->player_data->pool_figure) > 0 : true;
-            }
+    return true;
+}
+
+/**
+ * Get if a tile can never be stepped on, these are the obstacles jump point search plans around.
+ */
+static bool pathfinder_blocked(const pathfinder_walker *walker, int x, int y) {
+    const room_grid *grid = walker->grid;
+
+    if (x < 0 || y < 0 || x >= grid->size_x || y >= grid->size_y) {
+        return true;
+    }
+
+    return !(grid->flags[ROOM_GRID_INDEX(grid, x, y)] & ROOM_TILE_OPEN);
+}
+
+/**
+ * Get if a tile is open floor, where the tile and every open tile around it are bare floor of the
+ * same height. Any step from open floor to an open neighbour is valid, so jump point search only has
+ * to look at the walls there. Tiles near items, users and pool tiles are expanded like A* does.
+ *
+ * @param walker the walker
+ * @param x the x coordinate of the tile
+ * @param y the y coordinate of the tile
+ * @return true, if successful
+ */
+static bool pathfinder_open_floor(const pathfinder_walker *walker, int x, int y) {
+    const room_grid *grid = walker->grid;
+    int index = ROOM_GRID_INDEX(grid, x, y);
+
+    if (grid->flags[index] != ROOM_TILE_OPEN || grid->special[index] != ROOM_TILE_NORMAL) {
+        return false;
+    }
+
+    for (int i = 0; i < 8; i++) {
+        int x_neighbour = x + DIAGONAL_MOVE_POINTS[i].x;
+        int y_neighbour = y + DIAGONAL_MOVE_POINTS[i].y;
+
+        if (pathfinder_blocked(walker, x_neighbour, y_neighbour)) {
+            continue;
         }
 
-        if (strcmp(room_user->room->room_data->model_data->model_name, "pool_b") == 0
-            && strcmp(to_item->definition->sprite, "queue_tile2") == 0) {
+        int neighbour = ROOM_GRID_INDEX(grid, x_neighbour, y_neighbour);
 
-            if (to_item->position->x == 21 && to_item->position->y == 9) {
-                return room_user->player->player_data->tickets > 0 &&
-                       strlen(room_user->player->player_data->pool_figure) > 0;
-            } else {
-                return false;
-            }
+        if (grid->flags[neighbour] != ROOM_TILE_OPEN ||
+            grid->special[neighbour] != ROOM_TILE_NORMAL ||
+            grid->heights[neighbour] != grid->heights[index]) {
+            return false;
         }
     }
 
-    if (from.x != room_instance->room_data->model_data->door_x
-        && from.y != room_instance->room_data->model_data->door_y) {
+    return true;
+}
 
-        if (to_item != NULL) {
-            if (is_final_move) {
-                return item_is_walkable(to_item);
-            } else {
-                return to_item->definition->behaviour->can_stand_on_top;
-            }
-        }
+/**
+ * Get if moving in a direction over a tile passes a wall corner, behind which a path could
+ * turn that is shorter than going through the tile before.
+ */
+static bool pathfinder_forced(const pathfinder_walker *walker, int x, int y, int dx, int dy) {
+    if (dx != 0 && dy != 0) {
+        return (pathfinder_blocked(walker, x - dx, y) && !pathfinder_blocked(walker, x - dx, y + dy)) ||
+               (pathfinder_blocked(walker, x, y - dy) && !pathfinder_blocked(walker, x + dx, y - dy));
     }
 
+    if (dx != 0) {
+        return (pathfinder_blocked(walker, x, y + 1) && !pathfinder_blocked(walker, x + dx, y + 1)) ||
+               (pathfinder_blocked(walker, x, y - 1) && !pathfinder_blocked(walker, x + dx, y - 1));
+    }
 
-    return true;
+    return (pathfinder_blocked(walker, x + 1, y) && !pathfinder_blocked(walker, x + 1, y + dy)) ||
+           (pathfinder_blocked(walker, x - 1, y) && !pathfinder_blocked(walker, x - 1, y + dy));
 }
 
 /**
+ * Move from a tile in a direction for as long as nothing interesting happens, and return
+ * the tile where it does: the goal, a tile that isn't open floor, a wall corner, or for
+ * diagonal moves a tile from where a straight jump finds one of those.
  *
- * @param room_user
- * @param map_size_x
- * @param map_size_y
- * @return
+ * @param walker the walker
+ * @param x the x coordinate to jump from
+ * @param y the y coordinate to jump from
+ * @param dx the x direction
+ * @param dy the y direction
+ * @param goal the tile index of the goal
+ * @return the tile index of the jump point, -1 if the jump runs into something
  */
-pathfinder *make_path_reversed(room_user *room_user, int map_size_x, int map_size_y) {
-    pathfinder *p = malloc(sizeof(pathfinder));
-    p->nodes = NULL;
-    p->current = NULL;
-    p->failed = 0;
-    deque_new(&p->open_list);
-
-    coord c;
-    coord tmp;
-
-    p->current = create_node();
-    p->current->x = room_user->position->x;
-    p->current->y = room_user->position->y;
-
-    for (int x = 0; x < map_size_x ; x++) { 
-         for (int y = 0; y < map_size_y ; y++) { 
-            p->map[x][y] = NULL;
-         }
+static int pathfinder_jump(const pathfinder_walker *walker, int x, int y, int dx, int dy, int goal) {
+    const room_grid *grid = walker->grid;
+
+    while (true) {
+        int from = ROOM_GRID_INDEX(grid, x, y);
+
+        x += dx;
+        y += dy;
+
+        if (x < 0 || x >= grid->size_x || y < 0 || y >= grid->size_y) {
+            return -1;
+        }
+
+        int to = ROOM_GRID_INDEX(grid, x, y);
+
+        if (!is_valid_tile(walker, from, to, to == goal)) {
+            return -1;
+        }
+
+        if (to == goal || !pathfinder_open_floor(walker, x, y) || pathfinder_forced(walker, x, y, dx, dy)) {
+            return to;
+        }
+
+        if (dx != 0 && dy != 0 &&
+            (pathfinder_jump(walker, x, y, dx, 0, goal) != -1 || pathfinder_jump(walker, x, y, 0, dy, goal) != -1)) {
+            return to;
+        }
     }
+}
 
-    int cost = 0;
-    int diff = 0;
+/**
+ * Get the directions to jump in from a jump point. On open floor that's onwards in the
+ * direction it was reached from, plus the turns around wall corners. The start and tiles
+ * that aren't open floor look in every direction.
+ *
+ * @param p the pathfinder
+ * @param walker the walker
+ * @param current the tile index of the jump point
+ * @param moves the directions, room for 8
+ * @return the amount of directions
+ */
+static int pathfinder_prune(pathfinder *p, const pathfinder_walker *walker, int current, coord *moves) {
+    int x = current / p->map_size_y;
+    int y = current % p->map_size_y;
+    int parent = p->nodes[current].parent;
+
+    if (parent == -1 || !pathfinder_open_floor(walker, x, y)) {
+        memcpy(moves, DIAGONAL_MOVE_POINTS, sizeof(DIAGONAL_MOVE_POINTS));
+        return 8;
+    }
+
+    int parent_x = parent / p->map_size_y;
+    int parent_y = parent % p->map_size_y;
+
+    int dx = (x > parent_x) - (x < parent_x);
+    int dy = (y > parent_y) - (y < parent_y);
+    int count = 0;
+
+    if (dx != 0 && dy != 0) {
+        moves[count++] = (coord) { dx, dy, 0 };
+        moves[count++] = (coord) { dx, 0, 0 };
+        moves[count++] = (coord) { 0, dy, 0 };
+
+        if (pathfinder_blocked(walker, x - dx, y)) {
+            moves[count++] = (coord) { -dx, dy, 0 };
+        }
+
+        if (pathfinder_blocked(walker, x, y - dy)) {
+            moves[count++] = (coord) { dx, -dy, 0 };
+        }
+    } else if (dx != 0) {
+        moves[count++] = (coord) { dx, 0, 0 };
+
+        if (pathfinder_blocked(walker, x, y + 1)) {
+            moves[count++] = (coord) { dx, 1, 0 };
+        }
 
-    p->map[p->current->x][p->current->y] = p->current;
-    deque_add(p->open_list, p->current);
+        if (pathfinder_blocked(walker, x, y - 1)) {
+            moves[count++] = (coord) { dx, -1, 0 };
+        }
+    } else {
+        moves[count++] = (coord) { 0, dy, 0 };
+
+        if (pathfinder_blocked(walker, x + 1, y)) {
+            moves[count++] = (coord) { 1, dy, 0 };
+        }
+
+        if (pathfinder_blocked(walker, x - 1, y)) {
+            moves[count++] = (coord) { -1, dy, 0 };
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Search the cheapest path from the walker's position to the goal with A*. With jump point
+ * search the nodes are jump points instead of every tile, which costs the same but expands
+ * far fewer nodes in big open rooms. Both find a cheapest path, although when there are
+ * several equally cheap ones they may not pick the same one.
+ *
+ * @param p the pathfinder, from pathfinder_for_thread
+ * @param walker the walker
+ * @param goal the tile index of the goal
+ * @param jump_point_search whether to jump over open floor
+ * @param max_expanded the nodes to expand before giving up, 0 for no limit
+ * @return the tile index of the goal, -1 if it can't be reached
+ */
+int pathfinder_search(pathfinder *p, const pathfinder_walker *walker, int goal, bool jump_point_search, int max_expanded) {
+    int map_size_x = p->map_size_x;
+    int map_size_y = p->map_size_y;
 
-    while (deque_size(p->open_list) > 0) {
-        deque_remove_first(p->open_list, (void*)&p->current);
-        p->current->closed = 1;
+    int goal_x = goal / map_size_y;
+    int goal_y = goal % map_size_y;
 
-        for (int i = 0; i < 8; i++) {
-            tmp.x = p->current->x + DIAGONAL_MOVE_POINTS[i].x;
-            tmp.y = p->current->y + DIAGONAL_MOVE_POINTS[i].y;
+    coord from;
+    coord to;
+    coord pruned[8];
 
-            bool is_final_move = (tmp.x == room_user->goal->x && tmp.y == room_user->goal->y);
+    int start = walker->start;
+    pathfinder_node *start_node = &p->nodes[start];
 
-            c.x = p->current->x;
-            c.y = p->current->y;
+    start_node->generation = p->generation;
+    start_node->parent = -1;
+    start_node->cost = 0;
+    start_node->estimate = pathfinder_distance(start / map_size_y, start % map_size_y, goal_x, goal_y);
+    pathfinder_push(p, start);
 
-            if (is_valid_tile(room_user, c, tmp, is_final_move)) {
-                if (p->map[tmp.x][tmp.y] == NULL) {
-                    p->nodes = create_node();
-                    p->nodes->x = tmp.x;
-                    p->nodes->y = tmp.y;
-                    p->map[tmp.x][tmp.y] = p->nodes;
+    while (p->open_count > 0) {
+        int current = pathfinder_pop(p);
+        pathfinder_node *current_node = &p->nodes[current];
 
+        p->expanded++;
+
+        if (current == goal) {
+            return current;
+        }
+
+        if (max_expanded > 0 && p->expanded >= max_expanded) {
+            return -1;
+        }
+
+        from.x = current / map_size_y;
+        from.y = current % map_size_y;
+
+        coord *moves = DIAGONAL_MOVE_POINTS;
+        int move_count = 8;
+
+        if (jump_point_search) {
+            moves = pruned;
+            move_count = pathfinder_prune(p, walker, current, pruned);
+        }
+
+        for (int i = 0; i < move_count; i++) {
+            int neighbour;
+
+            if (jump_point_search) {
+                neighbour = pathfinder_jump(walker, from.x, from.y, moves[i].x, moves[i].y, goal);
+
+                if (neighbour == -1) {
+                    continue;
                 }
-                else {
-                    p->nodes = p->map[tmp.x][tmp.y];
+
+                to.x = neighbour / map_size_y;
+                to.y = neighbour % map_size_y;
+            } else {
+                to.x = from.x + moves[i].x;
+                to.y = from.y + moves[i].y;
+
+                if (to.x < 0 || to.x >= map_size_x || to.y < 0 || to.y >= map_size_y) {
+                    continue;
                 }
 
-                if (!p->nodes->closed) {
-                    diff = 0;
+                neighbour = to.x * map_size_y + to.y;
+            }
 
-                    if (p->current->x != p->nodes->x) {
-                        diff += 1;
-                    }
+            pathfinder_node *neighbour_node = &p->nodes[neighbour];
+            bool visited = neighbour_node->generation == p->generation;
 
-                    if (p->current->y != p->nodes->y) {
-                        diff += 1;
-                    }
+            if (visited && neighbour_node->heap_index == PATHFINDER_CLOSED) {
+                continue;
+            }
 
-                    cost = p->current->cost + diff + coord_distance_squared(&tmp, room_user->goal);
+            int cost = current_node->cost + pathfinder_distance(from.x, from.y, to.x, to.y);
 
-                    if (cost < p->nodes->cost) {
-                        p->nodes->cost = cost;
-                        p->nodes->node = (void *)p->current;
-                    }
+            if (visited && cost >= neighbour_node->cost) {
+                continue;
+            }
 
-                    if (!p->nodes->open) {
-                        if (p->nodes->x == room_user->goal->x && p->nodes->y == room_user->goal->y) {
-                            p->nodes->node = (void *)p->current;
-                            return p;
-                        }
+            // Jumps check every step on the way already
+            if (!jump_point_search && !is_valid_tile(walker, current, neighbour, neighbour == goal)) {
+                continue;
+            }
 
-                        p->nodes->open = 1;
-                        deque_add(p->open_list, p->nodes);
-                    }
-                }
+            neighbour_node->parent = current;
+            neighbour_node->cost = cost;
+            neighbour_node->estimate = cost + pathfinder_distance(to.x, to.y, goal_x, goal_y);
+
+            if (visited) {
+                pathfinder_sift_up(p, neighbour_node->heap_index);
+            } else {
+                neighbour_node->generation = p->generation;
+                pathfinder_push(p, neighbour);
             }
         }
     }
 
-    p->failed = 1;
-    return p;
-}
\ No newline at end of file
+    return -1;
+}
@@ -3,20 +3,45 @@
 
 #include "game/room/room_user.h"
 
-typedef struct node_s node;
+#define PATHFINDER_STRAIGHT_COST 10
+#define PATHFINDER_DIAGONAL_COST 14
+#define PATHFINDER_CLOSED -1
+
 typedef struct deque_s Deque;
 typedef struct coord_s coord;
+typedef struct room_grid_s room_grid;
+
+typedef struct pathfinder_node_s {
+    unsigned int generation; // the search the node was last touched by, older nodes are unvisited
+    int parent; // the tile the node was reached from, -1 for the start
+    int cost; // the cost of the best path found to the node so far
+    int estimate; // the cost plus the heuristic to the goal
+    int heap_index; // the position in the open heap, PATHFINDER_CLOSED once expanded
+} pathfinder_node;
+
+typedef struct pathfinder_walker_s {
+    const room_grid *grid; // the room map, or a snapshot of it
+    int start; // the tile the user stands on, it may walk out of whatever it's stuck in
+    bool has_pool_figure;
+    bool has_tickets;
+} pathfinder_walker;
 
 typedef struct pathfinder_s {
-    node *map[200][200];
-    Deque *open_list;
-    node *current;
-    node *nodes;
-    int failed;
+    pathfinder_node *nodes; // one per tile, indexed by x * map_size_y + y
+    int *open_heap;
+    int open_count;
+    int capacity;
+    int map_size_x;
+    int map_size_y;
+    int expanded; // the nodes taken off the open heap by the last search
+    unsigned int generation;
 } pathfinder;
 
 Deque *create_path(room_user*);
-pathfinder *make_path_reversed(room_user*, int, int);
-int is_valid_tile(room_user*, coord from, coord to, bool is_final_move);
+Deque *pathfinder_create_path(pathfinder*, const pathfinder_walker*, int goal, int max_expanded);
+pathfinder *pathfinder_for_thread(int map_size_x, int map_size_y);
+int pathfinder_search(pathfinder*, const pathfinder_walker*, int goal, bool jump_point_search, int max_expanded);
+void pathfinder_walker_init(pathfinder_walker*, room_user*, const room_grid*);
+bool is_valid_tile(const pathfinder_walker*, int from, int to, bool is_final_move);
 
-#endif
\ No newline at end of file
+#endif
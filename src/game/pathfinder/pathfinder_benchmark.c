@@ -0,0 +1,161 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+#include "list.h"
+
+#include "pathfinder.h"
+#include "pathfinder_benchmark.h"
+
+#include "game/room/mapping/room_map.h"
+#include "game/room/mapping/room_model.h"
+
+#include "util/scheduler.h"
+#include "util/stringbuilder.h"
+
+typedef struct pathfinder_benchmark_s {
+    int pairs;
+    int mismatches; // pairs where both searches didn't agree on the cost
+    unsigned long long expanded[2];
+    uint64_t nanos[2];
+} pathfinder_benchmark;
+
+/**
+ * Create a room grid from only the tiles of a model, without furniture or users.
+ *
+ * @param model the room model
+ * @return the room grid
+ */
+static room_grid *pathfinder_benchmark_grid(room_model *model) {
+    size_t tiles = (size_t) (model->map_size_x * model->map_size_y);
+
+    room_grid *grid = calloc(1, sizeof(room_grid));
+    grid->size_x = model->map_size_x;
+    grid->size_y = model->map_size_y;
+    grid->door_x = model->door_x;
+    grid->door_y = model->door_y;
+    grid->flags = calloc(tiles, sizeof(uint8_t));
+    grid->heights = calloc(tiles, sizeof(int16_t));
+    grid->special = calloc(tiles, sizeof(uint8_t));
+    grid->item_origin = malloc(tiles * sizeof(int));
+
+    for (int x = 0; x < model->map_size_x; x++) {
+        for (int y = 0; y < model->map_size_y; y++) {
+            int index = ROOM_GRID_INDEX(grid, x, y);
+            grid->item_origin[index] = -1;
+
+            if (model->states[x][y] == OPEN) {
+                grid->flags[index] = ROOM_TILE_OPEN;
+                grid->heights[index] = (int16_t) (model->heights[x][y] * 100);
+            }
+        }
+    }
+
+    return grid;
+}
+
+/**
+ * Search a path with both modes and add up the expanded nodes and time taken.
+ */
+static void pathfinder_benchmark_pair(pathfinder_benchmark *benchmark, pathfinder_walker *walker, int goal) {
+    int cost[2];
+
+    for (int mode = 0; mode < 2; mode++) {
+        uint64_t started = scheduler_now();
+
+        pathfinder *p = pathfinder_for_thread(walker->grid->size_x, walker->grid->size_y);
+        int found = pathfinder_search(p, walker, goal, mode == 1, 0);
+
+        benchmark->nanos[mode] += scheduler_now() - started;
+        benchmark->expanded[mode] += (unsigned long long) p->expanded;
+        cost[mode] = found == -1 ? -1 : p->nodes[found].cost;
+    }
+
+    if (cost[0] != cost[1]) {
+        benchmark->mismatches++;
+    }
+
+    benchmark->pairs++;
+}
+
+/**
+ * Run both search modes over the tiles of a model, from the door to tiles spread over the
+ * model and between tiles at opposite ends of the model.
+ *
+ * @param benchmark the totals to add to
+ * @param model the room model
+ */
+static void pathfinder_benchmark_model(pathfinder_benchmark *benchmark, room_model *model) {
+    room_grid *grid = pathfinder_benchmark_grid(model);
+    int *open = malloc(sizeof(int) * (size_t) (grid->size_x * grid->size_y));
+    int open_count = 0;
+
+    for (int index = 0; index < grid->size_x * grid->size_y; index++) {
+        if (grid->flags[index] & ROOM_TILE_OPEN) {
+            open[open_count++] = index;
+        }
+    }
+
+    if (open_count > 0) {
+        pathfinder_walker walker;
+        walker.grid = grid;
+        walker.has_pool_figure = true;
+        walker.has_tickets = true;
+
+        int door = ROOM_GRID_INDEX(grid, model->door_x, model->door_y);
+
+        if (model->door_x < 0 || model->door_x >= grid->size_x || model->door_y < 0 || model->door_y >= grid->size_y
+            || !(grid->flags[door] & ROOM_TILE_OPEN)) {
+            door = open[0];
+        }
+
+        for (int i = 0; i < PATHFINDER_BENCHMARK_PAIRS; i++) {
+            int tile = (int) ((long) i * open_count / PATHFINDER_BENCHMARK_PAIRS);
+
+            walker.start = door;
+            pathfinder_benchmark_pair(benchmark, &walker, open[tile]);
+
+            walker.start = open[tile];
+            pathfinder_benchmark_pair(benchmark, &walker, open[open_count - 1 - tile]);
+        }
+    }
+
+    free(open);
+    free(grid->flags);
+    free(grid->heights);
+    free(grid->special);
+    free(grid->item_origin);
+    free(grid);
+}
+
+/**
+ * Compare A* with jump point search for every loaded model, the models that have jump point
+ * search enabled are marked with a star.
+ *
+ * @param sb the string builder to append the table to
+ */
+void pathfinder_benchmark_append(stringbuilder *sb) {
+    char line[160];
+    sb_add_string(sb, "model                  searches  A* expanded JPS expanded     A* ms    JPS ms  mismatches\n");
+
+    for (size_t i = 0; i < list_size(global.room_model_manager.models); i++) {
+        room_model *model;
+        list_get_at(global.room_model_manager.models, i, (void *) &model);
+
+        pathfinder_benchmark benchmark = { 0 };
+        pathfinder_benchmark_model(&benchmark, model);
+
+        snprintf(line, sizeof(line), "%-20s %c %9i %12llu %12llu %9.2f %9.2f %11i\n",
+                 model->model_id,
+                 model->jump_point_search ? '*' : ' ',
+                 benchmark.pairs,
+                 benchmark.expanded[0],
+                 benchmark.expanded[1],
+                 benchmark.nanos[0] / 1e6,
+                 benchmark.nanos[1] / 1e6,
+                 benchmark.mismatches);
+
+        sb_add_string(sb, line);
+    }
+}
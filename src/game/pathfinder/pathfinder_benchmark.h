@@ -0,0 +1,10 @@
+#ifndef PATHFINDER_BENCHMARK_H
+#define PATHFINDER_BENCHMARK_H
+
+#define PATHFINDER_BENCHMARK_PAIRS 64 // searches from the door, and as many between other tiles
+
+typedef struct stringbuilder_s stringbuilder;
+
+void pathfinder_benchmark_append(stringbuilder *sb);
+
+#endif
@@ -17,11 +17,18 @@
 #include "game/room/room_manager.h"
 #include "game/room/manager/room_entity_manager.h"
 
+#include "util/actor.h"
+#include "util/ring_buffer.h"
+#include "util/shared_buffer.h"
 #include "util/stringbuilder.h"
 #include "util/configuration/configuration.h"
+#include "util/encoding/base64encoding.h"
 
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_registry.h"
+#include "communication/message_stats.h"
 
+#include "server/send_queue.h"
 #include "server/server_listener.h"
 #include "database/queries/player_query.h"
 
@@ -34,8 +41,19 @@ session *player_create(void *socket, char *ip_address) {
     player->stream = socket;
     player->disconnected = false;
     player->ip_address = strdup(ip_address);
+    player->receive_buffer = ring_buffer_create(RECEIVE_BUFFER_SIZE);
+    player->send_queue = send_queue_create();
+    player->io_loop = NULL;
+    player->ping_timer = NULL;
+    player->idle_timer = NULL;
+    player->route_room_id = 0;
+    memset(player->rate_buckets, 0, sizeof(player->rate_buckets));
+    atomic_init(&player->coalesce_pending, false);
+    atomic_init(&player->coalesced_body, 0);
+    player->manager_index = SIZE_MAX;
+    atomic_init(&player->references, 1);
     player->player_data = NULL;
-    player->logged_in = false;
+    atomic_init(&player->logged_in, false);
     player->ping_safe = true;
     player->room_user = NULL;
     player->messenger = NULL;
@@ -73,8 +91,6 @@ player_data *player_create_data(int id, char *username, char *password, char *fi
  * @param p the player struct
  */
 void player_login(session *player) {
-    outgoing_message *om;
-
     player->room_user = room_user_create(player);
     player->messenger = messenger_create();
     player->inventory = inventory_create();
@@ -85,14 +101,8 @@ void player_login(session *player) {
     player_query_save_last_online(player);
     room_manager_add_by_user_id(player->player_data->id);
 
-    om = om_create(2); // @B
-    om_write_str(om, "default\2fuse_login\2fuse_buy_credits\2fuse_trade\2fuse_room_queue_default\2fuse_performance_panel");
-    player_send(player, om);
-    om_cleanup(om);
-
-    om = om_create(3); // @C
-    player_send(player, om);
-    om_cleanup(om);
+    player_send_buffer(player, packet_registry_get(PACKET_FUSE_RIGHTS)); // @B
+    player_send_buffer(player, packet_registry_get(PACKET_LOGIN_OK)); // @C
 
     if (configuration_get_bool("welcome.message.enabled")) {
         char *welcome_template = configuration_get_string("welcome.message.content");
@@ -102,8 +112,8 @@ void player_login(session *player) {
         free(welcome_custom);
     }
 
-    player->ping_safe = true;
-    player->logged_in = true;
+    player_manager_index(player);
+    atomic_store(&player->logged_in, true);
 }
 
 /**
@@ -116,11 +126,12 @@ void player_disconnect(session *p) {
         return;
     }
 
-    uv_close((uv_handle_t *) p->stream, server_on_connection_close);
+    server_disconnect_session(p);
 }
 
 /**
- * Send an outgoing message to the socket
+ * Queue an outgoing message for the socket, everything queued during one loop
+ * iteration is written out together.
  *
  * @param p the player struct
  * @param om the outgoing message
@@ -130,28 +141,39 @@ void player_send(session *p, outgoing_message *om) {
         return;
     }
 
-    if (configuration_get_bool("debug")) {
+    if (global.configuration.debug) {
         char *preview = replace_unreadable_characters(om->sb->data);
         log_debug("Client [%s] outgoing data: %i / %s", p->ip_address, om->header_id, preview);
         free(preview);
     }
 
     om_finalise(om);
-    uv_write_t *req;
 
-    if(!(req = malloc(sizeof(uv_write_t)))){
+    shared_buffer *buffer = shared_buffer_create(om->sb->data, (size_t) om->sb->index);
+    player_send_buffer(p, buffer);
+    shared_buffer_release(buffer);
+}
+
+/**
+ * Queue an already finalised message for the socket, the session takes its own
+ * reference so the same buffer can be queued for many sessions. Every message sent
+ * to a session passes through here, so this is where outgoing traffic is counted.
+ *
+ * @param p the player struct
+ * @param buffer the finalised message
+ */
+void player_send_buffer(session *p, shared_buffer *buffer) {
+    if (buffer == NULL || p == NULL || p->disconnected) {
         return;
     }
 
-    size_t message_length = strlen(om->sb->data);
-
-    uv_buf_t buffer = uv_buf_init(malloc(message_length), (unsigned int) message_length);
-    memcpy(buffer.base, om->sb->data, message_length);
-
-    req->handle = (void*) p;
-    req->data = buffer.base;
+    if (buffer->length >= 2) {
+        message_stats_record_sent(base64_decode_length(buffer->data, 2), (int) buffer->length, 1);
+    }
 
-    int response = uv_write(req, (uv_stream_t *) p->stream, &buffer, 1, &server_on_write);
+    if (send_queue_push(p->send_queue, buffer, server_send_queue_limit(), ((uv_stream_t *) p->stream)->write_queue_size)) {
+        server_schedule_flush(p);
+    }
 }
 
 /**
@@ -325,7 +347,10 @@ void player_refresh_club(session *player) {
 }
 
 /**
- * Called when a connection is closed
+ * Called when a connection is closed, on the loop owning the session. The session
+ * leaves its room through the room's actor and the rest of the logout is handled
+ * by the hotel actor, the session itself is freed once nothing references it.
+ *
  * @param player the player struct
  */
 void player_cleanup(session *player) {
@@ -335,28 +360,72 @@ void player_cleanup(session *player) {
 
     player_manager_remove(player);
 
-    if (player->room_user != NULL) {
-        if (player->room_user->room != NULL) {
-            room_leave(player->room_user->room, player, false);
-        }
+    room_post_leave(player->route_room_id, player, false, NULL);
+    player->route_room_id = 0;
+
+    actor_post(global.thread_manager.hotel, player_logout_command, player_retain(player), (actor_release) player_release);
+    player_release(player);
+}
+
+/**
+ * Save the player and dispose the rooms they own, run by the hotel actor.
+ *
+ * @param state unused
+ * @param argument the session that disconnected
+ */
+void player_logout_command(void *state, void *argument) {
+    session *player = argument;
+
+    if (player->player_data == NULL) {
+        return;
     }
 
-    if (player->player_data != NULL) {
-        player_query_save_last_online(player);
+    player_query_save_last_online(player);
 
-        List *rooms = room_manager_get_by_user_id(player->player_data->id);
+    List *rooms = room_manager_get_by_user_id(player->player_data->id);
 
-        for (size_t i = 0; i < list_size(rooms); i++) {
-            room *room;
-            list_get_at(rooms, i, (void*)&room);
+    for (size_t i = 0; i < list_size(rooms); i++) {
+        room *room;
+        list_get_at(rooms, i, (void*)&room);
+        room_manager_post(room->room_id, room_dispose_command, NULL, NULL);
+        room_release(room);
+    }
 
-            if (room != NULL) {
-                room_dispose(room, false);
-            }
-        }
+    list_destroy(rooms);
+}
+
+/**
+ * Take a reference to the session, anything handing the session to another thread
+ * has to hold one.
+ *
+ * @param player the player struct
+ * @return the player struct
+ */
+session *player_retain(session *player) {
+    atomic_fetch_add_explicit(&player->references, 1, memory_order_relaxed);
+    return player;
+}
 
-        list_destroy(rooms);
+/**
+ * Drop a reference to the session, the last reference hands the session to the
+ * hotel actor to be freed.
+ *
+ * @param player the player struct
+ */
+void player_release(session *player) {
+    if (atomic_fetch_sub_explicit(&player->references, 1, memory_order_acq_rel) == 1) {
+        actor_post(global.thread_manager.hotel, player_destroy_command, player, NULL);
     }
+}
+
+/**
+ * Free the session and everything it owns, run by the hotel actor.
+ *
+ * @param state unused
+ * @param argument the session
+ */
+void player_destroy_command(void *state, void *argument) {
+    session *player = argument;
 
     if (player->room_user != NULL) {
         room_user_cleanup(player->room_user);
@@ -378,6 +447,8 @@ void player_cleanup(session *player) {
         player->player_data = NULL;
     }
 
+    send_queue_dispose(player->send_queue);
+    ring_buffer_dispose(player->receive_buffer);
     free(player->ip_address);
     free(player->stream);
     free(player);
@@ -2,8 +2,17 @@
 #define PLAYER_H
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <time.h>
+
+#include "communication/message_handler.h"
+
 typedef struct outgoing_message_s outgoing_message;
+typedef struct ring_buffer_s ring_buffer;
+typedef struct send_queue_s send_queue;
+typedef struct shared_buffer_s shared_buffer;
+typedef struct io_loop_s io_loop;
+typedef struct uv_timer_s uv_timer_t;
 
 typedef struct player_data_s {
     int id;
@@ -26,11 +35,22 @@ typedef struct player_data_s {
 typedef struct session_s {
     void *stream;
     char *ip_address;
+    ring_buffer *receive_buffer;
+    send_queue *send_queue;
+    io_loop *io_loop;
+    uv_timer_t *ping_timer;
+    uv_timer_t *idle_timer;
+    int route_room_id;
+    message_bucket rate_buckets[MESSAGE_RATE_CLASSES];
+    atomic_bool coalesce_pending;
+    atomic_uint coalesced_body;
+    size_t manager_index;
+    atomic_int references;
     struct player_data_s *player_data;
     struct messenger_s *messenger;
     struct inventory_s *inventory;
     struct room_user_s *room_user;
-    bool logged_in;
+    atomic_bool logged_in; // set by the hotel actor, read by the loop for every message
     bool disconnected;
     bool ping_safe;
 } session;
@@ -40,6 +60,7 @@ player_data *player_create_data(int, char*, char*, char*, char*, int, char*, cha
 void player_login(session*);
 void player_disconnect(session *p);
 void player_send(session *, outgoing_message *);
+void player_send_buffer(session *, shared_buffer *);
 void session_send_credits(session*);
 void session_send_tickets(session*);
 void send_localised_error(session*, char*);
@@ -48,6 +69,10 @@ void player_refresh_appearance(session *player);
 void player_club(session *player, int months);
 void player_refresh_club(session *player);
 void player_cleanup(session*);
+void player_logout_command(void *state, void *argument);
+session *player_retain(session*);
+void player_release(session*);
+void player_destroy_command(void *state, void *argument);
 void player_data_cleanup(player_data*);
 
 #endif
\ No newline at end of file
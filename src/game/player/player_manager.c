@@ -1,38 +1,119 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <strings.h>
+
 #include "shared.h"
 
-#include "list.h"
+#include "array.h"
+#include "hashtable.h"
 #include "player.h"
 
-#include "database/queries/player_query.h"
 #include "server/server_listener.h"
+
+static size_t player_manager_hash_id(const void *key, int length, uint32_t seed);
+static int player_manager_compare_id(const void *first, const void *second);
+static size_t player_manager_hash_name(const void *key, int length, uint32_t seed);
+static int player_manager_compare_name(const void *first, const void *second);
+
 /**
- * Create a new list to store players
+ * Create the session array and the lookup indexes by user id and username, they're
+ * guarded by a lock since sessions are accepted by several event loops.
  */
 void player_manager_init() {
-    list_new(&global.player_manager.players);
+    array_new(&global.player_manager.players);
+
+    HashTableConf id_conf;
+    hashtable_conf_init(&id_conf);
+    id_conf.key_length = sizeof(int);
+    id_conf.hash = player_manager_hash_id;
+    id_conf.key_compare = player_manager_compare_id;
+    hashtable_new_conf(&id_conf, &global.player_manager.players_by_id);
+
+    HashTableConf name_conf;
+    hashtable_conf_init(&name_conf);
+    name_conf.hash = player_manager_hash_name;
+    name_conf.key_compare = player_manager_compare_name;
+    hashtable_new_conf(&name_conf, &global.player_manager.players_by_name);
+
+    pthread_mutex_init(&global.player_manager.lock, NULL);
 }
 
 /**
- * Creates a new player when given a new network stream to add. Will return a
- * old player if the stream was already added.
+ * Creates a new player when given a new network stream to add. The player remembers
+ * its position in the session array so it can be removed without searching.
  *
  * @param stream the dyad stream
  * @return the player
  */
 session *player_manager_add(void *stream, char *ip) {
     session *p = player_create(stream, ip);
-    list_add(global.player_manager.players, p);
+
+    pthread_mutex_lock(&global.player_manager.lock);
+    p->manager_index = array_size(global.player_manager.players);
+    array_add(global.player_manager.players, p);
+    pthread_mutex_unlock(&global.player_manager.lock);
+
     return p;
 }
 
 /**
- * Removes a player by the given stream
- * @param stream the dyad stream
+ * Index a player by user id and username once they've logged in, a newer session
+ * of the same user replaces the older one in the index.
+ *
+ * @param p the player
+ */
+void player_manager_index(session *p) {
+    pthread_mutex_lock(&global.player_manager.lock);
+
+    // Adding an existing key only swaps the value and keeps the old key, which points into
+    // the player data of the older session and is freed along with it
+    hashtable_remove(global.player_manager.players_by_id, &p->player_data->id, NULL);
+    hashtable_remove(global.player_manager.players_by_name, p->player_data->username, NULL);
+
+    hashtable_add(global.player_manager.players_by_id, &p->player_data->id, p);
+    hashtable_add(global.player_manager.players_by_name, p->player_data->username, p);
+    pthread_mutex_unlock(&global.player_manager.lock);
+}
+
+/**
+ * Removes a player, the last session in the array is moved into the gap left
+ * behind by the removed one.
+ *
+ * @param p the player
  */
 void player_manager_remove(session *p) {
-    if (list_contains(global.player_manager.players, p)) {
-        list_remove(global.player_manager.players, p, NULL);
+    pthread_mutex_lock(&global.player_manager.lock);
+
+    size_t index = p->manager_index;
+    session *found = NULL;
+
+    if (index < array_size(global.player_manager.players)) {
+        array_get_at(global.player_manager.players, index, (void *) &found);
+    }
+
+    if (found == p) {
+        session *last;
+        array_remove_last(global.player_manager.players, (void *) &last);
+
+        if (last != p) {
+            array_replace_at(global.player_manager.players, last, index, NULL);
+            last->manager_index = index;
+        }
+
+        p->manager_index = SIZE_MAX;
+    }
+
+    if (p->player_data != NULL) {
+        if (hashtable_get(global.player_manager.players_by_id, &p->player_data->id, (void *) &found) == CC_OK && found == p) {
+            hashtable_remove(global.player_manager.players_by_id, &p->player_data->id, NULL);
+        }
+
+        if (hashtable_get(global.player_manager.players_by_name, p->player_data->username, (void *) &found) == CC_OK && found == p) {
+            hashtable_remove(global.player_manager.players_by_name, p->player_data->username, NULL);
+        }
     }
+
+    pthread_mutex_unlock(&global.player_manager.lock);
 }
 
 /**
@@ -46,74 +127,45 @@ session *player_manager_find(void *stream) {
 }
 
 /**
- * Find a player by user id
+ * Find a player by user id. The session is retained before the lock is let go, since its
+ * loop may be closing it meanwhile, release it with player_release when done.
  *
  * @param player_id the player id
- * @return the player, if sound, otherwise returns NULL
+ * @return the player, if found, otherwise returns NULL
  */
 session *player_manager_find_by_id(int player_id) {
-    if (list_size(global.player_manager.players) > 0) {
-        for (size_t i = 0; i < list_size(global.player_manager.players); i++) {
-            session *p;
-            list_get_at(global.player_manager.players, i, (void *) &p);
-
-            if (!p->logged_in) {
-                continue;
-            }
-
-            if (p->player_data->id == player_id) {
-                return p;
-            }
-        }
+    session *found = NULL;
+
+    pthread_mutex_lock(&global.player_manager.lock);
+
+    if (hashtable_get(global.player_manager.players_by_id, &player_id, (void *) &found) == CC_OK) {
+        player_retain(found);
     }
 
-    return NULL;
+    pthread_mutex_unlock(&global.player_manager.lock);
+
+    return found;
 }
 
 /**
- * Find a player by user id
+ * Find a player by username, ignoring case. The session is retained like with
+ * player_manager_find_by_id, release it with player_release when done.
  *
- * @param player_id the player id
- * @return the player, if sound, otherwise returns NULL
+ * @param name the username
+ * @return the player, if found, otherwise returns NULL
  */
 session *player_manager_find_by_name(char *name) {
-    if (list_size(global.player_manager.players) > 0) {
-        for (size_t i = 0; i < list_size(global.player_manager.players); i++) {
-            session *p;
-            list_get_at(global.player_manager.players, i, (void *) &p);
-
-            if (!p->logged_in) {
-                continue;
-            }
-
-            if (strcmp(p->player_data->username, name) == 0) {
-                return p;
-            }
-        }
-    }
+    session *found = NULL;
 
-    return NULL;
-}
+    pthread_mutex_lock(&global.player_manager.lock);
 
-/**
- * Find a player by user id
- *
- * @param player_id the player id
- * @return the player, if sound, otherwise returns NULL
- */
-player_data *player_manager_get_data_by_id(int player_id) {
-    if (list_size(global.player_manager.players) > 0) {
-        for (size_t i = 0; i < list_size(global.player_manager.players); i++) {
-            session *p;
-            list_get_at(global.player_manager.players, i, (void *) &p);
-
-            if (p->player_data->id == player_id) {
-                return (player_data *) p->player_data;
-            }
-        }
+    if (hashtable_get(global.player_manager.players_by_name, name, (void *) &found) == CC_OK) {
+        player_retain(found);
     }
 
-    return player_query_data(player_id);
+    pthread_mutex_unlock(&global.player_manager.lock);
+
+    return found;
 }
 
 /**
@@ -122,27 +174,74 @@ player_data *player_manager_get_data_by_id(int player_id) {
 * @param player_id the player id
 */
 void player_manager_destroy_session_by_id(int player_id) {
-    for (size_t i = 0; i < list_size(global.player_manager.players); i++) {
-        session *p;
-        list_get_at(global.player_manager.players, i, (void*)&p);
+    session *found = NULL;
 
-        if (!p->logged_in || p->player_data->id != player_id) {
-            continue;
-        }
+    pthread_mutex_lock(&global.player_manager.lock);
 
-        uv_close((uv_handle_t *) p->stream, server_on_connection_close);
+    if (hashtable_get(global.player_manager.players_by_id, &player_id, (void *) &found) == CC_OK) {
+        server_disconnect_session(found);
     }
+
+    pthread_mutex_unlock(&global.player_manager.lock);
+}
+
+/**
+ * Get the amount of connected sessions
+ *
+ * @return the amount of sessions
+ */
+int player_manager_count() {
+    pthread_mutex_lock(&global.player_manager.lock);
+    int count = (int) array_size(global.player_manager.players);
+    pthread_mutex_unlock(&global.player_manager.lock);
+
+    return count;
 }
 
 /**
  * Dispose model manager
  */
 void player_manager_dispose() {
-    for (size_t i = 0; i < list_size(global.player_manager.players); i++) {
+    for (size_t i = 0; i < array_size(global.player_manager.players); i++) {
         session *player;
-        list_get_at(global.player_manager.players, i, (void *) &player);
+        array_get_at(global.player_manager.players, i, (void *) &player);
         player_disconnect(player);
     }
 
-    list_destroy(global.player_manager.players);
-}
\ No newline at end of file
+    hashtable_destroy(global.player_manager.players_by_id);
+    hashtable_destroy(global.player_manager.players_by_name);
+    array_destroy(global.player_manager.players);
+}
+
+/**
+ * Hash a user id, the ids are already unique so they're only mixed a little.
+ */
+static size_t player_manager_hash_id(const void *key, int length, uint32_t seed) {
+    uint32_t hash = (uint32_t) *(const int *) key ^ seed;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static int player_manager_compare_id(const void *first, const void *second) {
+    return *(const int *) first != *(const int *) second;
+}
+
+/**
+ * Hash a username case-folded (FNV-1a), so names are looked up regardless of case.
+ */
+static size_t player_manager_hash_name(const void *key, int length, uint32_t seed) {
+    size_t hash = 2166136261u ^ seed;
+
+    for (const unsigned char *name = key; *name != '\0'; name++) {
+        hash ^= (size_t) tolower(*name);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static int player_manager_compare_name(const void *first, const void *second) {
+    return strcasecmp(first, second);
+}
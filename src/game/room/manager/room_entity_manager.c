@@ -1,10 +1,10 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "log.h"
 #include "list.h"
 #include "hashtable.h"
-#include "thpool.h"
 
 #include "database/queries/rooms/room_vote_query.h"
 
@@ -23,10 +23,12 @@
 
 #include "game/room/manager/room_entity_manager.h"
 
+#include "util/actor.h"
 #include "util/stringbuilder.h"
 #include "util/threading.h"
 
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_registry.h"
 
 /**
  * Get a unused instance id for the room they're in.
@@ -71,9 +73,9 @@ room_user *get_room_user_by_instance_id(room *room, int instance_id) {
  * @param player the player
  */
 void room_enter(room *room, session *player) {
-    // Leave other room
-    if (player->room_user->room != NULL) {
-        room_leave(player->room_user->room, player, false);
+    // Re-entering the same room, any other room was already left through its own actor
+    if (player->room_user->room == room) {
+        room_leave(room, player, false);
     }
 
     if (list_size(room->users) == 0) {
@@ -90,6 +92,7 @@ void room_enter(room *room, session *player) {
     room_entity->room = room;
     room_entity->room_id = room->room_id;
     room_entity->instance_id = create_instance_id(room_entity);
+    room_entity->status_dirty = true;
     room_user_reset_idle_timer(player->room_user);
 
     room_entity->position->x = room->room_data->model_data->door_x;
@@ -101,26 +104,17 @@ void room_enter(room *room, session *player) {
                        room->room_data->model_data->door_dir);
 
     list_add(room->users, player);
-    room->room_data->visitors_now = (int) list_size(room->users);
-
-    if (room->room_schedule_job == NULL) {
-        room->room_schedule_job = create_runnable();
-        room->room_schedule_job->request = room_task;
-        room->room_schedule_job->room_id = room->room_id;
-        room->room_schedule_job->millis = 500;
-        thpool_add_work(global.thread_manager.pool, (void *) do_room_task, room->room_schedule_job);
-    }
+    atomic_store(&room->room_data->visitors_now, (int) list_size(room->users));
+
+    room_schedule_task(room);
 
     /*outgoing_message *om = om_create(73); // "AI"
     player_send(session, om);
     om_cleanup(om);*/
 
-    outgoing_message *om = om_create(166); // "Bf"
-    om_write_str(om, "/client/");
-    player_send(player, om);
-    om_cleanup(om);
+    player_send_buffer(player, packet_registry_get(PACKET_ROOM_URL)); // "Bf"
 
-    om = om_create(69); // "AE"
+    outgoing_message *om = om_create(69); // "AE"
     sb_add_string(om->sb, room->room_data->model);
     sb_add_string(om->sb, " ");
     sb_add_int(om->sb, room->room_id);
@@ -219,11 +213,11 @@ void room_leave(room *room, session *player, bool hotel_view) {
     }
 
     list_remove(room->users, player, NULL);
-    room->room_data->visitors_now = (int) list_size(room->users);
+    atomic_store(&room->room_data->visitors_now, (int) list_size(room->users));
 
     // Remove current user from tile
     room_tile *current_tile = room->room_map->map[player->room_user->position->x][player->room_user->position->y];
-    current_tile->entity = NULL;
+    room_map_set_entity(room, player->room_user->position->x, player->room_user->position->y, NULL);
 
     // Reset item program state for pool items
     item *item = current_tile->highest_item;
@@ -257,6 +251,74 @@ void room_leave(room *room, session *player, bool hotel_view) {
     }
 }
 
+/**
+ * Make the player leave a room through the room's actor. The gate, if any, is opened
+ * once the player left or if the room isn't loaded at all.
+ *
+ * @param room_id the room to leave
+ * @param player the player
+ * @param hotel_view whether to send the player to the hotel view
+ * @param gate the gate to open afterwards, may be NULL
+ */
+void room_post_leave(int room_id, session *player, bool hotel_view, actor_gate *gate) {
+    room_transition *transition = malloc(sizeof(room_transition));
+    transition->player = player_retain(player);
+    transition->gate = gate;
+    transition->hotel_view = hotel_view;
+
+    if (!room_manager_post(room_id, room_leave_command, transition, room_transition_release)) {
+        room_transition_release(transition);
+    }
+}
+
+/**
+ * Leave the room, run by the room's actor.
+ *
+ * @param state the room
+ * @param argument the room transition
+ */
+void room_leave_command(void *state, void *argument) {
+    room_transition *transition = argument;
+    room_leave((room *) state, transition->player, transition->hotel_view);
+}
+
+/**
+ * Cleanup a room transition, the gate is opened even if the leave never ran.
+ *
+ * @param argument the room transition
+ */
+void room_transition_release(void *argument) {
+    room_transition *transition = argument;
+
+    if (transition->gate != NULL) {
+        actor_gate_open(transition->gate);
+    }
+
+    player_release(transition->player);
+    free(transition);
+}
+
+/**
+ * Kick the user back to the hotel view if they idled for too long, run by the room's
+ * actor once the loop owning the session saw the idle deadline pass. The deadline is
+ * checked again since the user may have done something in the meantime.
+ *
+ * @param state the room
+ * @param argument the session
+ */
+void room_kick_idle_command(void *state, void *argument) {
+    room *room = state;
+    session *player = argument;
+
+    if (player->room_user == NULL || player->room_user->room != room) {
+        return;
+    }
+
+    if (time(NULL) > player->room_user->room_idle_timer) {
+        room_leave(room, player, true); // Kick and send to hotel view
+    }
+}
+
 /**
  * Append user list to the packet.
  *
@@ -293,33 +355,74 @@ void append_user_list(outgoing_message *players, session *player) {
 }
 
 /**
- * Append user statuses to the packet
+ * Check if the cached status line of the room user no longer matches the user, either because
+ * a status changed or because the user moved or turned since it was built.
  *
- * @param om the outgoing message
- * @param player the player
+ * @param room_user the room user
+ * @return true, if the status line needs to be rebuilt
  */
-void append_user_status(outgoing_message *om, session *player) {
-    sb_add_int_delimeter(om->sb, player->room_user->instance_id, ' ');
-    sb_add_int_delimeter(om->sb, player->room_user->position->x, ',');
-    sb_add_int_delimeter(om->sb, player->room_user->position->y, ',');
-    sb_add_float_delimeter(om->sb, player->room_user->position->z, ',');
-    sb_add_int_delimeter(om->sb, player->room_user->position->head_rotation, ',');
-    sb_add_int_delimeter(om->sb, player->room_user->position->body_rotation, '/');
-
-    if (hashtable_size(player->room_user->statuses) > 0) {
+static bool room_user_status_stale(room_user *room_user) {
+    coord *position = room_user->position;
+    coord *cached = &room_user->status_position;
+
+    return room_user->status_dirty
+        || position->x != cached->x
+        || position->y != cached->y
+        || position->z != cached->z
+        || position->head_rotation != cached->head_rotation
+        || position->body_rotation != cached->body_rotation;
+}
+
+/**
+ * Rebuild the cached status line of the room user.
+ *
+ * @param room_user the room user
+ */
+static void room_user_build_status(room_user *room_user) {
+    stringbuilder *sb = room_user->status_cache;
+    sb_reset(sb);
+
+    sb_add_int_delimeter(sb, room_user->instance_id, ' ');
+    sb_add_int_delimeter(sb, room_user->position->x, ',');
+    sb_add_int_delimeter(sb, room_user->position->y, ',');
+    sb_add_float_delimeter(sb, room_user->position->z, ',');
+    sb_add_int_delimeter(sb, room_user->position->head_rotation, ',');
+    sb_add_int_delimeter(sb, room_user->position->body_rotation, '/');
+
+    if (hashtable_size(room_user->statuses) > 0) {
         HashTableIter iter;
 
         TableEntry *entry;
-        hashtable_iter_init(&iter, player->room_user->statuses);
+        hashtable_iter_init(&iter, room_user->statuses);
 
         while (hashtable_iter_next(&iter, &entry) != CC_ITER_END) {
             room_user_status *rus = entry->value;
 
-            sb_add_string(om->sb, rus->key);
-            sb_add_string(om->sb, rus->value);
-            sb_add_string(om->sb, "/");
+            sb_add_string(sb, rus->key);
+            sb_add_string(sb, rus->value);
+            sb_add_char(sb, '/');
         }
     }
 
-    sb_add_char(om->sb, 13);
-}
\ No newline at end of file
+    sb_add_char(sb, 13);
+
+    room_user->status_position = *room_user->position;
+    room_user->status_dirty = false;
+}
+
+/**
+ * Append user statuses to the packet, the status line is only serialised again
+ * when something in it changed since the last time it was sent.
+ *
+ * @param om the outgoing message
+ * @param player the player
+ */
+void append_user_status(outgoing_message *om, session *player) {
+    room_user *room_user = player->room_user;
+
+    if (room_user_status_stale(room_user)) {
+        room_user_build_status(room_user);
+    }
+
+    sb_add_bytes(om->sb, room_user->status_cache->data, room_user->status_cache->index);
+}
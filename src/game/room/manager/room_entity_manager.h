@@ -1,14 +1,29 @@
 #ifndef ROOM_ENTITY_MANAGER_H
 #define ROOM_ENTITY_MANAGER_H
 
+#include <stdbool.h>
+
 typedef struct room_s room;
 typedef struct room_user_s room_user;
+typedef struct session_s session;
+typedef struct outgoing_message_s outgoing_message;
+typedef struct actor_gate_s actor_gate;
+
+typedef struct room_transition_s {
+    session *player;
+    actor_gate *gate;
+    bool hotel_view;
+} room_transition;
 
 int create_instance_id(room_user*);
 room_user *get_room_user_by_instance_id(room*, int);
 
 void room_enter(room*, session*);
 void room_leave(room*, session*, bool hotel_view);
+void room_post_leave(int room_id, session *player, bool hotel_view, actor_gate *gate);
+void room_leave_command(void *state, void *argument);
+void room_transition_release(void *argument);
+void room_kick_idle_command(void *state, void *argument);
 
 void append_user_list(outgoing_message *players, session *player);
 void append_user_status(outgoing_message *om, session *player);
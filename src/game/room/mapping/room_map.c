@@ -12,6 +12,7 @@
 
 #include "game/pathfinder/coord.h"
 #include "game/pathfinder/affected_tiles.h"
+#include "game/pathfinder/path_cache.h"
 
 #include "game/items/item.h"
 #include "game/items/definition/item_definition.h"
@@ -53,7 +54,28 @@ int cmp(void const *e1, void const *e2) {
  */
 void room_map_init(room *room) {
     if (room->room_map == NULL) {
+        room_model *model = room->room_data->model_data;
+        size_t tiles = (size_t) (model->map_size_x * model->map_size_y);
+
         room->room_map = malloc(sizeof(room_map));
+        room->room_map->version = 0;
+        room->room_map->layout_version = 0;
+        room->room_map->path_cache = path_cache_create();
+        room->room_map->snapshot = NULL;
+        room->room_map->snapshot_version = 0;
+
+        room_grid *grid = &room->room_map->grid;
+        grid->size_x = model->map_size_x;
+        grid->size_y = model->map_size_y;
+        grid->door_x = model->door_x;
+        grid->door_y = model->door_y;
+        grid->entities_block = list_size(model->public_items) == 0;
+        grid->jump_point_search = model->jump_point_search;
+        grid->flags = calloc(tiles, sizeof(uint8_t));
+        grid->heights = calloc(tiles, sizeof(int16_t));
+        grid->special = calloc(tiles, sizeof(uint8_t));
+        grid->item_origin = malloc(tiles * sizeof(int));
+        atomic_init(&grid->references, 1);
 
         for (int x = 0; x < room->room_data->model_data->map_size_x; x++) {
             for (int y = 0; y < room->room_data->model_data->map_size_y; y++) {
@@ -93,6 +115,218 @@ void room_map_regenerate(room *room) {
     }
 
     room_map_add_items(room);
+
+    for (int x = 0; x < room->room_data->model_data->map_size_x; x++) {
+        for (int y = 0; y < room->room_data->model_data->map_size_y; y++) {
+            room_map_refresh_tile(room, x, y);
+        }
+    }
+}
+
+/**
+ * Update the pathfinder state of a tile from the tile and its highest item, the
+ * sprite checks are done here once instead of for every step of every path.
+ *
+ * @param room the room instance
+ * @param x the x coordinate of the tile
+ * @param y the y coordinate of the tile
+ */
+void room_map_refresh_tile(room *room, int x, int y) {
+    room_map *map = room->room_map;
+    room_grid *grid = &map->grid;
+
+    if (x < 0 || y < 0 || x >= grid->size_x || y >= grid->size_y) {
+        return;
+    }
+
+    int index = ROOM_GRID_INDEX(grid, x, y);
+    room_tile *tile = map->map[x][y];
+
+    map->version++;
+    map->layout_version++;
+
+    uint8_t flags = 0;
+    room_tile_special special = ROOM_TILE_NORMAL;
+
+    grid->item_origin[index] = -1;
+
+    if (tile == NULL || room->room_data->model_data->states[x][y] == CLOSED) {
+        grid->flags[index] = 0;
+        grid->heights[index] = 0;
+        grid->special[index] = ROOM_TILE_NORMAL;
+        return;
+    }
+
+    flags |= ROOM_TILE_OPEN;
+
+    if (tile->entity != NULL) {
+        flags |= ROOM_TILE_OCCUPIED;
+    }
+
+    item *top = tile->highest_item;
+
+    if (top != NULL) {
+        flags |= ROOM_TILE_HAS_ITEM;
+
+        if (item_is_walkable(top)) {
+            flags |= ROOM_TILE_ITEM_WALKABLE;
+        }
+
+        if (top->definition->behaviour->can_stand_on_top) {
+            flags |= ROOM_TILE_ITEM_STANDABLE;
+        }
+
+        if (top->position->x >= 0 && top->position->x < grid->size_x &&
+            top->position->y >= 0 && top->position->y < grid->size_y) {
+            grid->item_origin[index] = ROOM_GRID_INDEX(grid, top->position->x, top->position->y);
+        }
+
+        char *sprite = top->definition->sprite;
+
+        if (strcmp(sprite, "poolEnter") == 0 || strcmp(sprite, "poolExit") == 0) {
+            special = ROOM_TILE_POOL_ENTRANCE;
+        } else if (strcmp(sprite, "poolLift") == 0) {
+            special = ROOM_TILE_POOL_LIFT;
+        } else if (strcmp(sprite, "poolBooth") == 0) {
+            special = ROOM_TILE_POOL_BOOTH;
+        } else if (strcmp(sprite, "queue_tile2") == 0
+                   && strcmp(room->room_data->model_data->model_name, "pool_b") == 0) {
+            special = (top->position->x == 21 && top->position->y == 9) ? ROOM_TILE_QUEUE_START : ROOM_TILE_QUEUE;
+        }
+
+        if ((special == ROOM_TILE_POOL_LIFT || special == ROOM_TILE_POOL_BOOTH)
+            && top->current_program_state != NULL && strcmp(top->current_program_state, "close") == 0) {
+            flags |= ROOM_TILE_PROGRAM_CLOSED;
+        }
+    }
+
+    double height = tile->tile_height * 100;
+
+    if (height > INT16_MAX) {
+        height = INT16_MAX;
+    } else if (height < INT16_MIN) {
+        height = INT16_MIN;
+    }
+
+    grid->flags[index] = flags;
+    grid->heights[index] = (int16_t) (height < 0 ? height - 0.5 : height + 0.5);
+    grid->special[index] = (uint8_t) special;
+}
+
+/**
+ * Update the pathfinder state of every tile an item is the highest item of, after its
+ * state changed without the map being regenerated. That's not only the tiles the item
+ * stands on, pool booths are also made the highest item of the tile in front of them.
+ *
+ * @param room the room instance
+ * @param item the item
+ */
+void room_map_refresh_item(room *room, item *item) {
+    if (room->room_map == NULL || item->definition->behaviour->is_wall_item) {
+        return;
+    }
+
+    room_map *map = room->room_map;
+
+    for (int x = 0; x < map->grid.size_x; x++) {
+        for (int y = 0; y < map->grid.size_y; y++) {
+            room_tile *tile = map->map[x][y];
+
+            if (tile != NULL && tile->highest_item == item) {
+                room_map_refresh_tile(room, x, y);
+            }
+        }
+    }
+}
+
+/**
+ * Set the room user standing on a tile, NULL if nobody stands there anymore.
+ *
+ * @param room the room instance
+ * @param x the x coordinate of the tile
+ * @param y the y coordinate of the tile
+ * @param entity the room user
+ */
+void room_map_set_entity(room *room, int x, int y, room_user *entity) {
+    room_map *map = room->room_map;
+    room_grid *grid = &map->grid;
+
+    if (x < 0 || y < 0 || x >= grid->size_x || y >= grid->size_y || map->map[x][y] == NULL) {
+        return;
+    }
+
+    map->map[x][y]->entity = entity;
+    map->version++;
+
+    int index = ROOM_GRID_INDEX(grid, x, y);
+
+    if (entity != NULL) {
+        grid->flags[index] |= ROOM_TILE_OCCUPIED;
+    } else {
+        grid->flags[index] &= (uint8_t) ~ROOM_TILE_OCCUPIED;
+    }
+}
+
+/**
+ * Get a copy of the pathfinder state of the room, which can be searched from any thread
+ * while the room goes on. The copy is shared by every search until the room map changes.
+ *
+ * @param room the room instance
+ * @return the copy, give it back with room_grid_release
+ */
+room_grid *room_map_snapshot(room *room) {
+    room_map *map = room->room_map;
+
+    if (map->snapshot != NULL && map->snapshot_version == map->version) {
+        atomic_fetch_add(&map->snapshot->references, 1);
+        return map->snapshot;
+    }
+
+    if (map->snapshot != NULL) {
+        room_grid_release(map->snapshot);
+    }
+
+    size_t tiles = (size_t) (map->grid.size_x * map->grid.size_y);
+    room_grid *snapshot = malloc(sizeof(room_grid));
+
+    snapshot->size_x = map->grid.size_x;
+    snapshot->size_y = map->grid.size_y;
+    snapshot->door_x = map->grid.door_x;
+    snapshot->door_y = map->grid.door_y;
+    snapshot->entities_block = map->grid.entities_block;
+    snapshot->jump_point_search = map->grid.jump_point_search;
+    snapshot->flags = malloc(tiles * sizeof(uint8_t));
+    snapshot->heights = malloc(tiles * sizeof(int16_t));
+    snapshot->special = malloc(tiles * sizeof(uint8_t));
+    snapshot->item_origin = malloc(tiles * sizeof(int));
+
+    memcpy(snapshot->flags, map->grid.flags, tiles * sizeof(uint8_t));
+    memcpy(snapshot->heights, map->grid.heights, tiles * sizeof(int16_t));
+    memcpy(snapshot->special, map->grid.special, tiles * sizeof(uint8_t));
+    memcpy(snapshot->item_origin, map->grid.item_origin, tiles * sizeof(int));
+
+    atomic_init(&snapshot->references, 2); // the room map and the caller
+    map->snapshot = snapshot;
+    map->snapshot_version = map->version;
+
+    return snapshot;
+}
+
+/**
+ * Give back a snapshot from room_map_snapshot, the last one to do so frees it.
+ *
+ * @param grid the snapshot
+ */
+void room_grid_release(room_grid *grid) {
+    if (atomic_fetch_sub(&grid->references, 1) != 1) {
+        return;
+    }
+
+    free(grid->flags);
+    free(grid->heights);
+    free(grid->special);
+    free(grid->item_origin);
+    free(grid);
 }
 
 
@@ -176,26 +410,18 @@ void room_map_add_item(room *room, item *item) {
     list_add(room->items, item);
 
     if (item->definition->behaviour->is_wall_item) {
-        char *item_str = item_as_string(item);
-
         outgoing_message *om = om_create(83); // "AS"
-        sb_add_string(om->sb, item_str);
+        item_append_string(item, om->sb);
         room_send(room, om);
         om_cleanup(om);
-
-        free(item_str);
     } else {
         room_map_item_adjustment(room, item, false);
         room_map_regenerate(room);
 
-        char *item_str = item_as_string(item);
-
         outgoing_message *om = om_create(93); // "A]"
-        sb_add_string(om->sb, item_str);
+        item_append_string(item, om->sb);
         room_send(room, om);
         om_cleanup(om);
-
-        free(item_str);
     }
 
     item_update_entities(item, room, NULL);
@@ -217,14 +443,10 @@ void room_map_move_item(room *room, item *item, bool rotation, coord *old_positi
         room_map_item_adjustment(room, item, rotation);
         room_map_regenerate(room);
 
-        char *item_str = item_as_string(item);
-
         outgoing_message *om = om_create(95); // "A_"
-        sb_add_string(om->sb, item_str);
+        item_append_string(item, om->sb);
         room_send(room, om);
         om_cleanup(om);
-
-        free(item_str);
     }
 
     item_update_entities(item, room, old_position);
@@ -248,14 +470,10 @@ void room_map_remove_item(room *room, item *item) {
     } else {
         room_map_regenerate(room);
 
-        char *item_str = item_as_string(item);
-
         outgoing_message *om = om_create(94); // "A^"
-        sb_add_string(om->sb, item_str);
+        item_append_string(item, om->sb);
         room_send(room, om);
         om_cleanup(om);
-
-        free(item_str);
     }
 
     item_update_entities(item, room, NULL);
@@ -297,11 +515,9 @@ void room_map_item_adjustment(room *room, item *adjusted_item, bool rotation) {
             item->position->rotation = adjusted_item->position->rotation;
 
             // Update rooms users
-            char *item_str = item_as_string(item);
             outgoing_message *om = om_create(95); // "A_"
-            sb_add_string(om->sb, item_str);
+            item_append_string(item, om->sb);
             room_send(rooms, om);
-            free(item_str);
         }*/
    } else {
         adjusted_item->position->z = tile->tile_height;
@@ -326,6 +542,17 @@ void room_map_destroy(room *room) {
             }
         }
 
+        free(room->room_map->grid.flags);
+        free(room->room_map->grid.heights);
+        free(room->room_map->grid.special);
+        free(room->room_map->grid.item_origin);
+
+        if (room->room_map->snapshot != NULL) {
+            room_grid_release(room->room_map->snapshot);
+        }
+
+        path_cache_dispose(room->room_map->path_cache);
+
         free(room->room_map);
         room->room_map = NULL;
     }
@@ -1,14 +1,57 @@
 #ifndef ROOM_MAP_H
 #define ROOM_MAP_H
 
+#include <stdint.h>
+#include <stdatomic.h>
+
 #include "game/room/room.h"
 
+// Bits of room_grid.flags, the per tile state the pathfinder reads
+#define ROOM_TILE_OPEN 1 // the tile exists and isn't closed in the model
+#define ROOM_TILE_OCCUPIED 2 // a room user stands on the tile
+#define ROOM_TILE_HAS_ITEM 4
+#define ROOM_TILE_ITEM_WALKABLE 8 // the highest item can be walked onto, see item_is_walkable
+#define ROOM_TILE_ITEM_STANDABLE 16 // the highest item can be walked over
+#define ROOM_TILE_PROGRAM_CLOSED 32 // the highest item is a pool lift or booth that is closed
+
+#define ROOM_GRID_INDEX(grid, x, y) ((x) * (grid)->size_y + (y))
+
 typedef struct list_s List;
 typedef struct room_tile_s room_tile;
 typedef struct coord_s coord;
+typedef struct path_cache_s path_cache;
+
+typedef enum room_tile_special_e {
+    ROOM_TILE_NORMAL,
+    ROOM_TILE_POOL_ENTRANCE, // poolEnter and poolExit, leaving them needs a swimsuit
+    ROOM_TILE_POOL_LIFT,
+    ROOM_TILE_POOL_BOOTH,
+    ROOM_TILE_QUEUE, // queue_tile2 in pool_b
+    ROOM_TILE_QUEUE_START // the queue_tile2 at 21,9 in pool_b, where the ticket is taken
+} room_tile_special;
+
+typedef struct room_grid_s {
+    int size_x;
+    int size_y;
+    int door_x;
+    int door_y;
+    bool entities_block; // users can't walk through each other, except in public rooms
+    bool jump_point_search; // see room_model.jump_point_search
+    uint8_t *flags; // the arrays below have a value per tile, indexed with ROOM_GRID_INDEX
+    int16_t *heights; // the tile height in hundredths
+    uint8_t *special;
+    int *item_origin; // the index of the tile the highest item stands on, -1 without item
+    atomic_int references; // only used by snapshots
+} room_grid;
 
 typedef struct room_map_s {
     room_tile *map[200][200];
+    room_grid grid; // the per tile state the pathfinder reads
+    unsigned int version; // bumped whenever the grid changes
+    unsigned int layout_version; // bumped when tiles or items change, users moving around don't count
+    path_cache *path_cache;
+    room_grid *snapshot; // the last copy handed out for searching, while version hasn't changed
+    unsigned int snapshot_version;
 } room_map;
 
 void room_map_init(room *);
@@ -17,6 +60,11 @@ void room_map_add_item(room *room, item *item);
 void room_map_move_item(room *room, item *item, bool rotation, coord *old_position);
 void room_map_remove_item(room *room, item *item);
 void room_map_item_adjustment(room *room, item *adjusted_item, bool rotation);
+void room_map_refresh_tile(room *room, int x, int y);
+void room_map_refresh_item(room *room, item *item);
+void room_map_set_entity(room *room, int x, int y, room_user *entity);
+room_grid *room_map_snapshot(room *room);
+void room_grid_release(room_grid *grid);
 void room_map_destroy(room*);
 
 
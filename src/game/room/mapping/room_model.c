@@ -31,6 +31,7 @@ room_model *room_model_create(char *model_id, char *model_name, int door_x, int
     model->map_size_y = 0;
     model->heightmap = replace(heightmap, "|", "\r");
     model->public_items = NULL;
+    model->jump_point_search = false;
 
     List *items = item_parser_get_items(model->model_id);
 
@@ -1,6 +1,8 @@
 #ifndef ROOM_MODEL_H
 #define ROOM_MODEL_H
 
+#include <stdbool.h>
+
 typedef struct list_s List;
 
 typedef enum {
@@ -19,6 +21,7 @@ typedef struct room_model_s {
     List *public_items;
     int map_size_x;
     int map_size_y;
+    bool jump_point_search; // pathfind with jump point search, for big open public rooms
     room_title_states states[200][200];
     double heights[200][200];
 } room_model;
@@ -8,11 +8,34 @@
 
 #include "room_model.h"
 
+#include "util/configuration/configuration.h"
+
 /**
  * Initialise the model manager.
  */
 void model_manager_init() {
     global.room_model_manager.models = room_query_get_models();
+
+    char *models = configuration_get_string("pathfinder.jump.point.models");
+
+    if (models == NULL) {
+        return;
+    }
+
+    char *list = strdup(models);
+    char *model_id = strtok(list, ",");
+
+    while (model_id != NULL) {
+        room_model *model = model_manager_get(model_id);
+
+        if (model != NULL) {
+            model->jump_point_search = true;
+        }
+
+        model_id = strtok(NULL, ",");
+    }
+
+    free(list);
 }
 
 /**
@@ -14,10 +14,15 @@
 
 #include "game/room/manager/room_item_manager.h"
 #include "game/room/manager/room_entity_manager.h"
+#include "game/room/room_task.h"
 
 #include "game/player/player.h"
 #include "game/items/item.h"
 
+#include "util/actor.h"
+#include "util/stringbuilder.h"
+#include "util/shared_buffer.h"
+
 #include "database/queries/player_query.h"
 #include "database/queries/rooms/room_rights_query.h"
 
@@ -36,7 +41,9 @@ room *room_create(int room_id) {
     list_new(&instance->users);
     list_new(&instance->items);
     instance->rights = room_query_rights(room_id);
+    instance->actor = actor_create(instance);
     instance->tick = 0;
+    atomic_init(&instance->references, 1);
     return instance;
 }
 
@@ -83,7 +90,7 @@ room_data *room_create_data(room *room, int id, int owner_id, int category, char
     data->superusers = superusers;
     data->accesstype = accesstype;
     data->password = strdup(password);
-    data->visitors_now = visitors_now;
+    atomic_init(&data->visitors_now, visitors_now);
     data->visitors_max = visitors_max;
 
     List *public_items = data->model_data->public_items;
@@ -128,7 +135,7 @@ void room_append_data(room *instance, outgoing_message *navigator, int player_id
         om_write_int(navigator, instance->room_data->id); // rooms id
         om_write_int(navigator, 1);
         om_write_str(navigator, instance->room_data->name);
-        om_write_int(navigator, instance->room_data->visitors_now); // current visitors
+        om_write_int(navigator, atomic_load(&instance->room_data->visitors_now)); // current visitors
         om_write_int(navigator, instance->room_data->visitors_max); // max vistors
         om_write_int(navigator, instance->room_data->category); // category id
         om_write_str(navigator, instance->room_data->description); // description
@@ -159,7 +166,7 @@ void room_append_data(room *instance, outgoing_message *navigator, int player_id
             om_write_str(navigator, "open");
         }
 
-        om_write_int(navigator, instance->room_data->visitors_now); // current visitors
+        om_write_int(navigator, atomic_load(&instance->room_data->visitors_now)); // current visitors
         om_write_int(navigator, instance->room_data->visitors_max); // max vistors
         om_write_str(navigator, instance->room_data->description); // description
     }
@@ -285,7 +292,8 @@ void room_refresh_rights(room *room, session *player) {
 }
 
 /**
- * Send an outgoing message to all the room users.
+ * Send an outgoing message to all the room users. The message is serialised once
+ * and every user's queue references the same buffer.
  *
  * @param room the room
  * @param message the outgoing message to send
@@ -293,11 +301,25 @@ void room_refresh_rights(room *room, session *player) {
 void room_send(room *room, outgoing_message *message) {
     om_finalise(message);
 
+    if (list_size(room->users) == 0) {
+        return;
+    }
+
+    if (global.configuration.debug) {
+        char *preview = replace_unreadable_characters(message->sb->data);
+        log_debug("Room [%i] outgoing data: %i / %s", room->room_id, message->header_id, preview);
+        free(preview);
+    }
+
+    shared_buffer *buffer = shared_buffer_create(message->sb->data, (size_t) message->sb->index);
+
     for (size_t i = 0; i < list_size(room->users); i++) {
         session *player;
         list_get_at(room->users, i, (void*)&player);
-        player_send(player, message);
+        player_send_buffer(player, buffer);
     }
+
+    shared_buffer_release(buffer);
 }
 
 /**
@@ -334,7 +356,8 @@ List *room_nearby_players(room *room, room_user *room_user, coord *position, int
 }
 
 /**
- * Cleanup a room instance.
+ * Cleanup a room instance, a room that can be unloaded is removed from the manager and the
+ * manager's reference is dropped, the memory is freed once every other holder released it.
  *
  * @param room the room instance.
  */
@@ -344,6 +367,7 @@ void room_dispose(room *room, bool force_dispose) {
     }
 
     room->tick = 0;
+    room_cancel_task(room);
     room_map_destroy(room);
 
     if (room->room_data->model_data->public_items != NULL && list_size(room->room_data->model_data->public_items) > 0 && !force_dispose) { // model is a public rooms model
@@ -353,11 +377,37 @@ void room_dispose(room *room, bool force_dispose) {
 
     room_item_manager_dispose(room);
 
-    if (!force_dispose &&player_manager_find_by_id(room->room_data->owner_id) != NULL) {
+    session *owner = force_dispose ? NULL : player_manager_find_by_id(room->room_data->owner_id);
+
+    if (owner != NULL) {
+        player_release(owner);
         return;
     }
 
-    room_manager_remove(room->room_id);
+    if (room_manager_remove(room)) {
+        room_release(room);
+    }
+}
+
+/**
+ * Take a reference to a room, the room stays allocated until the reference is released
+ * with room_release.
+ *
+ * @param room the room instance
+ */
+void room_retain(room *room) {
+    atomic_fetch_add(&room->references, 1);
+}
+
+/**
+ * Release a reference to a room, the last release frees the room.
+ *
+ * @param room the room instance
+ */
+void room_release(room *room) {
+    if (atomic_fetch_sub(&room->references, 1) != 1) {
+        return;
+    }
 
     for (size_t i = 0; i < list_size(room->rights); i++) {
         rights_entry *rights_entry;
@@ -371,8 +421,7 @@ void room_dispose(room *room, bool force_dispose) {
 
     room->users = NULL;
     room->rights = NULL;
-    room->users = NULL;
-
+    room->items = NULL;
 
     if (room->room_data != NULL) {
         free(room->room_data->name);
@@ -384,5 +433,17 @@ void room_dispose(room *room, bool force_dispose) {
         room->room_data = NULL;
     }
 
+    actor_dispose(room->actor);
     free(room);
+}
+
+/**
+ * Dispose the room from its own actor, used when the room is disposed on behalf of
+ * another thread.
+ *
+ * @param state the room
+ * @param argument unused
+ */
+void room_dispose_command(void *state, void *argument) {
+    room_dispose((room *) state, false);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define ROOM_H
 
 #include <stdbool.h>
+#include <stdatomic.h>
 
 typedef struct room_user_s room_user;
 typedef struct coord_s coord;
@@ -9,8 +10,9 @@ typedef struct list_s List;
 typedef struct session_s session;
 typedef struct room_model_s room_model;
 typedef struct outgoing_message_s outgoing_message;
-typedef struct runnable_s runnable;
+typedef struct scheduled_task_s scheduled_task;
 typedef struct room_map_s room_map;
+typedef struct actor_s actor;
 
 typedef struct rights_entry_s {
     int user_id;
@@ -32,7 +34,7 @@ typedef struct room_data_s {
     bool superusers;
     int accesstype;
     char *password;
-    int visitors_now;
+    atomic_int visitors_now;
     int visitors_max;
 } room_data;
 
@@ -40,11 +42,13 @@ typedef struct room_s {
     int room_id;
     struct room_data_s *room_data;
     room_map *room_map;
-    runnable *room_schedule_job;
+    scheduled_task *room_schedule_job;
     List *users;
     List *items;
     List *rights;
+    actor *actor;
     unsigned long tick;
+    atomic_int references;
 } room;
 
 room *room_create(int);
@@ -59,6 +63,9 @@ bool room_has_rights(room *room, int user_id);
 void room_refresh_rights(room *room, session *player);
 void room_send(room*, outgoing_message*);
 void room_dispose(room*, bool force_dispose);
+void room_retain(room *room);
+void room_release(room *room);
+void room_dispose_command(void *state, void *argument);
 List *room_nearby_players(room *room, room_user *room_user, coord *position, int distance);
 
 
@@ -9,10 +9,12 @@
 void room_manager_add_public_rooms();
 
 /**
- * Create a new hashtable to store rooms
+ * Create a new hashtable to store rooms, the table is guarded by a lock since rooms
+ * are looked up by the event loops, the hotel actor and every room actor.
  */
 void room_manager_init() {
     hashtable_new(&global.room_manager.rooms);
+    pthread_mutex_init(&global.room_manager.lock, NULL);
     room_manager_add_public_rooms();
 }
 
@@ -25,52 +27,84 @@ void room_manager_add_public_rooms() {
     ListIter iter;
     list_iter_init(&iter, rooms);
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     room *room;
     while (list_iter_next(&iter, (void *)&room) != CC_ITER_END) {
         if (!hashtable_contains_key(global.room_manager.rooms, &room->room_id)) {
             hashtable_add(global.room_manager.rooms, &room->room_id, room);
+        } else {
+            room_release(room);
         }
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
     list_destroy(rooms);
 }
 
 /**
  * Add a room by room id if the room doesn't exist, will fetch data
- * from the database.
+ * from the database. The query runs without the manager locked, if another
+ * thread added the room in the meantime the fetched room is released again.
  *
  * @param room_id the room id
  */
 void room_manager_add(int room_id) {
-    if (hashtable_contains_key(global.room_manager.rooms, &room_id)) {
+    room *room = room_manager_get_by_id(room_id);
+
+    if (room != NULL) {
+        room_release(room);
+        return;
+    }
+
+    room = room_query_get_by_room_id(room_id);
+
+    if (room == NULL) {
         return;
     }
 
-    room *room = room_query_get_by_room_id(room_id);
-    hashtable_add(global.room_manager.rooms, &room->room_id, room);
+    pthread_mutex_lock(&global.room_manager.lock);
+
+    if (!hashtable_contains_key(global.room_manager.rooms, &room_id)) {
+        hashtable_add(global.room_manager.rooms, &room->room_id, room);
+        room = NULL;
+    }
+
+    pthread_mutex_unlock(&global.room_manager.lock);
+
+    if (room != NULL) {
+        room_release(room);
+    }
 }
 
 /*
  * Add rooms by user id, will check if the rooms exists
- * before adding a new rooms.
+ * before adding a new rooms. The reference of every room that was
+ * added is handed over to the manager.
  */
 void room_manager_add_by_user_id(int user_id) {
     List *rooms = room_query_get_by_owner_id(user_id);
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     for (size_t i = 0; i < list_size(rooms); i++) {
         room *room;
         list_get_at(rooms, i, (void*)&room);
         
         if (!hashtable_contains_key(global.room_manager.rooms, &room->room_id)) {
             hashtable_add(global.room_manager.rooms, &room->room_id, room);
+        } else {
+            room_release(room);
         }
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
     list_destroy(rooms);
 }
 
 /**
- * Get rooms by user id.
+ * Get rooms by user id, every room in the list is retained and must be
+ * released with room_release.
  * 
  * @param user_id the user id
  * @return the list of rooms
@@ -79,6 +113,8 @@ List *room_manager_get_by_user_id(int user_id) {
     List *rooms;
     list_new(&rooms);
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     if (hashtable_size(global.room_manager.rooms) > 0) {
         HashTableIter iter;
         hashtable_iter_init(&iter, global.room_manager.rooms);
@@ -88,16 +124,19 @@ List *room_manager_get_by_user_id(int user_id) {
             room *room = entry->value;
 
             if (room->room_data->owner_id == user_id) {
+                room_retain(room);
                 list_add(rooms, room);
             }
         }
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
     return rooms;
 }
 
 /**
- * Get room manager by the room id.
+ * Get room manager by the room id, the room is retained and must be released
+ * with room_release.
  * 
  * @param room_id the room id
  * @return the room
@@ -109,26 +148,81 @@ room *room_manager_get_by_id(int room_id) {
         return room;
     }
 
+    pthread_mutex_lock(&global.room_manager.lock);
+
     if (hashtable_contains_key(global.room_manager.rooms, &room_id)) {
         hashtable_get(global.room_manager.rooms, &room_id, (void *)&room);
+        room_retain(room);
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
     return room;
 }
 
 /**
- * Remove the room by room id.
+ * Remove the room from the manager, rooms only loaded for the navigator are never
+ * added to the manager and are left alone.
+ *
+ * @param instance the room instance
+ * @return true, if the room was removed and the caller now owns the manager's reference
+ */
+bool room_manager_remove(room *instance) {
+    bool removed = false;
+    pthread_mutex_lock(&global.room_manager.lock);
+
+    room *managed = NULL;
+
+    if (hashtable_get(global.room_manager.rooms, &instance->room_id, (void *)&managed) == CC_OK && managed == instance) {
+        hashtable_remove(global.room_manager.rooms, &instance->room_id, NULL);
+        removed = true;
+    }
+
+    pthread_mutex_unlock(&global.room_manager.lock);
+    return removed;
+}
+
+/**
+ * Post a message to the actor of a loaded room. The lookup and the post happen under
+ * the manager lock, a room is removed from the manager before its actor is disposed
+ * so the actor is never posted to after it was freed.
  *
  * @param room_id the room id
+ * @param callback the callback run by the room's actor
+ * @param argument the argument of the callback
+ * @param release called once the message was handled or dropped, may be NULL
+ * @return true, if the room was loaded and the message was posted
  */
-void room_manager_remove(int room_id) {
-    if (hashtable_contains_key(global.room_manager.rooms, &room_id)) {
-        hashtable_remove(global.room_manager.rooms, &room_id, NULL);
+bool room_manager_post(int room_id, actor_callback callback, void *argument, actor_release release) {
+    return room_manager_post_after(room_id, NULL, callback, argument, release);
+}
+
+/**
+ * Post a message to the actor of a loaded room, the room holds back the message and
+ * everything posted after it until the gate is opened.
+ *
+ * @param room_id the room id
+ * @param gate the gate to wait for, NULL to run straight away
+ * @param callback the callback run by the room's actor
+ * @param argument the argument of the callback
+ * @param release called once the message was handled or dropped, may be NULL
+ * @return true, if the room was loaded and the message was posted
+ */
+bool room_manager_post_after(int room_id, actor_gate *gate, actor_callback callback, void *argument, actor_release release) {
+    room *room = NULL;
+    pthread_mutex_lock(&global.room_manager.lock);
+
+    if (room_id > 0 && hashtable_contains_key(global.room_manager.rooms, &room_id)) {
+        hashtable_get(global.room_manager.rooms, &room_id, (void *)&room);
+        actor_post_after(room->actor, gate, callback, argument, release);
     }
+
+    pthread_mutex_unlock(&global.room_manager.lock);
+    return room != NULL;
 }
 
 /**
- * Sort list by room population. Highest populated rooms appear first.
+ * Sort list by room population. Highest populated rooms appear first, the population is
+ * the visitor count published by each room's actor so any thread may sort.
  *
  * @param e1 the first room
  * @param e2 the second room
@@ -138,8 +232,8 @@ int room_manager_sort(void const *e1, void const *e2) {
     room *i = (*((room **) e1));
     room *j = (*((room **) e2));
 
-    size_t room_size_i = list_size(i->users);
-    size_t room_size_j = list_size(j->users);
+    int room_size_i = atomic_load(&i->room_data->visitors_now);
+    int room_size_j = atomic_load(&j->room_data->visitors_now);
 
     if (room_size_i > room_size_j)
         return -1;
@@ -177,17 +271,29 @@ int room_manager_sort_id(void const *e1, void const *e2) {
  * Dispose room manager.
  */
 void room_manager_dispose() {
-    if (hashtable_size(global.room_manager.rooms) > 0) {
-        HashTableIter iter;
-        hashtable_iter_init(&iter, global.room_manager.rooms);
+    List *rooms;
+    list_new(&rooms);
 
-        TableEntry *entry;
-        while (hashtable_iter_next(&iter, &entry) != CC_ITER_END) {
-            room *room = entry->value;
-            room_dispose(room, true);
-        }
+    pthread_mutex_lock(&global.room_manager.lock);
+
+    HashTableIter iter;
+    hashtable_iter_init(&iter, global.room_manager.rooms);
+
+    TableEntry *entry;
+    while (hashtable_iter_next(&iter, &entry) != CC_ITER_END) {
+        list_add(rooms, entry->value);
     }
 
+    pthread_mutex_unlock(&global.room_manager.lock);
+
+    // Disposing removes the room from the table, so dispose from a copy
+    for (size_t i = 0; i < list_size(rooms); i++) {
+        room *room;
+        list_get_at(rooms, i, (void *) &room);
+        room_dispose(room, true);
+    }
+
+    list_destroy(rooms);
     hashtable_destroy(global.room_manager.rooms);
 
 }
\ No newline at end of file
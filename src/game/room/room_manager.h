@@ -1,12 +1,18 @@
 #ifndef ROOM_MANAGER_H
 #define ROOM_MANAGER_H
 
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "util/actor.h"
+
 typedef struct list_s List;
 typedef struct hashtable_s HashTable;
 typedef struct room_s room;
 
 struct room_manager {
     HashTable *rooms;
+    pthread_mutex_t lock;
 };
 
 void room_manager_init();
@@ -14,7 +20,9 @@ void room_manager_add(int);
 void room_manager_add_by_user_id(int);
 List *room_manager_get_by_user_id(int);
 room *room_manager_get_by_id(int);
-void room_manager_remove(int);
+bool room_manager_remove(room *instance);
+bool room_manager_post(int room_id, actor_callback callback, void *argument, actor_release release);
+bool room_manager_post_after(int room_id, actor_gate *gate, actor_callback callback, void *argument, actor_release release);
 int room_manager_sort_id(void const *e1, void const *e2);
 int room_manager_sort(void const *e1, void const *e2);
 void room_manager_dispose();
@@ -1,7 +1,15 @@
+#include <stdint.h>
+
+#include "log.h"
+#include "list.h"
+
 #include "room_task.h"
 #include "shared.h"
 
+#include "util/scheduler.h"
+
 #include "game/room/room.h"
+#include "game/room/manager/room_entity_manager.h"
 
 #include "game/room/tasks/roller_task.h"
 #include "game/room/tasks/status_task.h"
@@ -26,4 +34,68 @@ void room_task(room *room) {
     }
 
     room->tick += 500;
+}
+
+/**
+ * Start ticking the room at a fixed rate, called by the room's actor.
+ *
+ * @param room the room to tick
+ */
+void room_schedule_task(room *room) {
+    if (room->room_schedule_job != NULL) {
+        return;
+    }
+
+    room->room_schedule_job = scheduler_schedule(global.thread_manager.scheduler, room_tick_fire,
+                                                 (void *) (intptr_t) room->room_id, ROOM_TICK_MILLIS, ROOM_TICK_MILLIS);
+}
+
+/**
+ * Stop ticking the room, called by the room's actor.
+ *
+ * @param room the room
+ */
+void room_cancel_task(room *room) {
+    if (room->room_schedule_job == NULL) {
+        return;
+    }
+
+    // The scheduler frees every task itself when it's disposed on shutdown
+    if (global.thread_manager.scheduler != NULL) {
+        scheduler_cancel(global.thread_manager.scheduler, room->room_schedule_job);
+    }
+
+    room->room_schedule_job = NULL;
+}
+
+/**
+ * Called by the scheduler thread when the room is due for a tick, the tick itself
+ * is run by the room's actor.
+ *
+ * @param argument the room id
+ */
+void room_tick_fire(void *argument) {
+    room_manager_post((int) (intptr_t) argument, room_tick_command, NULL, NULL);
+}
+
+/**
+ * Run a single tick of the room, the task is stopped once the room is empty.
+ *
+ * @param state the room
+ * @param argument unused
+ */
+void room_tick_command(void *state, void *argument) {
+    room *room = state;
+
+    if (room->room_schedule_job == NULL) {
+        return;
+    }
+
+    if (list_size(room->users) == 0) {
+        log_info("Room %i unloaded.", room->room_id);
+        room_cancel_task(room);
+        return;
+    }
+
+    room_task(room);
 }
\ No newline at end of file
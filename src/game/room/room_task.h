@@ -1,4 +1,7 @@
-typedef struct runnable_s runnable;
 typedef struct room_s room;
 
-void room_task(room *room);
\ No newline at end of file
+void room_task(room *room);
+void room_schedule_task(room *room);
+void room_cancel_task(room *room);
+void room_tick_fire(void *argument);
+void room_tick_command(void *state, void *argument);
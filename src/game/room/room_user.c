@@ -22,6 +22,7 @@
 #include "game/items/definition/item_definition.h"
 
 #include "game/pathfinder/pathfinder.h"
+#include "game/pathfinder/path_request.h"
 #include "game/pathfinder/coord.h"
 
 #include "util/stringbuilder.h"
@@ -40,7 +41,10 @@ room_user *room_user_create(session *player) {
     user->goal = create_coord(0, 0);
     user->next = NULL;
     user->walk_list = NULL;
+    user->path_request = NULL;
     hashtable_new(&user->statuses);
+    user->status_cache = sb_create();
+    sb_shrink(user->status_cache, ROOM_USER_STATUS_CAPACITY);
     room_user_reset(user);
     return user;
 }
@@ -64,6 +68,7 @@ void room_user_reset(room_user *room_user) {
 
     room_user->is_walking = false;
     room_user->needs_update = false;
+    room_user->status_dirty = true;
     room_user->walking_lock = false;
     room_user->is_diving = false;
     room_user->authenticate_id = -1;
@@ -103,6 +108,11 @@ void room_user_cleanup(room_user *room_user) {
         room_user->statuses = NULL;
     }
 
+    if (room_user->status_cache != NULL) {
+        sb_cleanup(room_user->status_cache);
+        room_user->status_cache = NULL;
+    }
+
     room_user->room = NULL;
     free(room_user);
 }
@@ -158,25 +168,19 @@ void walk_to(room_user *room_user, int x, int y) {
         }
     }
 
-    if (room_user->next != NULL) {
-        room_user->position->x = room_user->next->x;
-        room_user->position->y = room_user->next->y;
-        room_user->needs_update = true;
-
-        free(room_user->next);
-        room_user->next = NULL;
+    // The step the user is taking is finished, the rest of the old path is dropped
+    if (room_user->walk_list != NULL) {
+        while (deque_size(room_user->walk_list) > 0) {
+            coord *step;
+            deque_remove_first(room_user->walk_list, (void *) &step);
+            free(step);
+        }
     }
 
     room_user->goal->x = x;
     room_user->goal->y = y;
 
-    Deque *path = create_path(room_user);
-
-    if (path != NULL && deque_size(path) > 0) {
-        room_user_clear_walk_list(room_user);
-        room_user->walk_list = path;
-        room_user->is_walking = true;
-    }
+    path_request_submit(room_user);
 }
 
 /**
@@ -190,6 +194,7 @@ void stop_walking(room_user *room_user, bool is_silent) {
         room_user->next = NULL;
     }
 
+    path_request_cancel(room_user);
     room_user_remove_status(room_user, "mv");
     room_user_clear_walk_list(room_user);
     room_user->is_walking = false;
@@ -382,7 +387,7 @@ void room_user_invoke_item(room_user *room_user) {
     room_user->needs_update = needs_update;
 }
 
-void room_user_carry_item(room_user *room_user, int carry_id, char *carry_name) {
+void room_user_carry_item(room_user *room_user, int carry_id, const char *carry_name) {
     enum drink_type {
         DRINK,
         EAT,
@@ -494,6 +499,7 @@ void room_user_add_status(room_user *room_user, char *key, char *value, int sec_
     status->action_switch_countdown = -1;
 
     hashtable_add(room_user->statuses, key, status);
+    room_user->status_dirty = true;
 }
 
 /**
@@ -510,6 +516,8 @@ void room_user_remove_status(room_user *room_user, char *key) {
         free(cleanup->value);
         free(cleanup->action);
         free(cleanup);
+
+        room_user->status_dirty = true;
     }
 }
 
@@ -2,15 +2,20 @@
 #define ROOM_USER_H
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <ctype.h>
 
 #include "game/room/room.h"
+#include "game/pathfinder/coord.h"
+
+#define ROOM_USER_STATUS_CAPACITY 128
 
 typedef struct item_s item;
 typedef struct deque_s Deque;
-typedef struct coord_s coord;
 typedef struct outgoing_message_s outgoing_message;
 typedef struct hashtable_s HashTable;
+typedef struct stringbuilder_s stringbuilder;
+typedef struct path_request_s path_request;
 
 typedef struct room_user_s {
     session *player;
@@ -22,14 +27,18 @@ typedef struct room_user_s {
     coord *goal;
     coord *next;
     Deque *walk_list;
+    path_request *path_request; // the path being searched, taken over by the walk task
     int is_walking;
     int is_typing;
     int needs_update;
     HashTable *statuses;
+    stringbuilder *status_cache; // serialised status line, rebuilt when status_dirty or the position moved
+    coord status_position;
+    bool status_dirty;
     bool walking_lock;
     bool is_diving;
     int lido_vote;
-    int room_idle_timer;
+    atomic_int room_idle_timer;
     int room_look_at_timer;
 } room_user;
 
@@ -57,7 +66,7 @@ void room_user_invoke_item(room_user *room_user);
 void room_user_clear_walk_list(room_user*);
 void append_user_list(outgoing_message*, session*);
 void append_user_status(outgoing_message*, session*);
-void room_user_carry_item(room_user *room_user, int carry_id, char *carry_name);
+void room_user_carry_item(room_user *room_user, int carry_id, const char *carry_name);
 void room_user_reset(room_user*);
 void room_user_cleanup(room_user*);
 void room_user_add_status(room_user*,char*,char*,int,char*,int,int);
@@ -179,7 +179,6 @@ void do_roller_player(room *room, item *roller, room_user *room_entity) {
     from.x = room_entity->position->x;
     from.y = room_entity->position->y;
 
-    room_tile *previous_tile = room->room_map->map[from.x][from.y];
     room_tile *next_tile = room->room_map->map[to.x][to.y];
 
     to.z = next_tile->tile_height;
@@ -204,6 +203,6 @@ void do_roller_player(room *room, item *roller, room_user *room_entity) {
     room_send(room, om);
     om_cleanup(om);
 
-    previous_tile->entity = NULL;
-    next_tile->entity = room_entity;
+    room_map_set_entity(room, from.x, from.y, NULL);
+    room_map_set_entity(room, to.x, to.y, room_entity);
 }
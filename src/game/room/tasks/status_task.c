@@ -65,6 +65,7 @@ void process_user_status(room_user *room_user) {
 
                 // Swap back to original key and update status
                 rus->key = key;
+                room_user->status_dirty = true;
                 room_user->needs_update = true;
             }
 
@@ -76,6 +77,7 @@ void process_user_status(room_user *room_user) {
 
                 // Swap key to action and update status
                 rus->key = rus->action;
+                room_user->status_dirty = true;
                 room_user->needs_update = true;
             }
 
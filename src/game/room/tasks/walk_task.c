@@ -7,6 +7,7 @@
 
 #include "game/pathfinder/coord.h"
 #include "game/pathfinder/rotation.h"
+#include "game/pathfinder/path_request.h"
 
 #include "game/room/room.h"
 #include "game/room/room_user.h"
@@ -19,6 +20,8 @@
 
 #include "communication/messages/outgoing_message.h"
 
+#include "util/encoding/decimalencoding.h"
+
 #include "shared.h"
 
 void process_user(session *player);
@@ -73,37 +76,55 @@ void walk_task(room *room) {
 void process_user(session *player) {
     room_user *room_entity = (room_user*)player->room_user;
 
-    if (room_entity->is_walking) {
-        if (room_entity->next != NULL) {
-            room_entity->position->x = room_entity->next->x;
-            room_entity->position->y = room_entity->next->y;
-            room_entity->position->z = room_entity->next->z;
-            free(room_entity->next);
-        }
+    if (room_entity->is_walking && room_entity->next != NULL) {
+        room_entity->position->x = room_entity->next->x;
+        room_entity->position->y = room_entity->next->y;
+        room_entity->position->z = room_entity->next->z;
+        free(room_entity->next);
+        room_entity->next = NULL;
+    }
+
+    // Paths are searched off the room, the ones that came in since the last cycle start now
+    path_request_apply(room_entity);
 
+    if (room_entity->is_walking) {
         if (deque_size(room_entity->walk_list) > 0) {
             coord *next;
             deque_remove_first(room_entity->walk_list, (void*)&next);
 
             if (!room_tile_is_walkable(room_entity->room, room_entity, next->x, next->y)) {
-                room_entity->next = NULL;
                 free(next);
 
-                walk_to(room_entity, room_entity->goal->x, room_entity->goal->y);
-                process_user(player);
-                return;
+                // Stand still until the way around is found, unless a short detour will do
+                if (!path_request_repair(room_entity)) {
+                    stop_walking(room_entity, true);
+                    path_request_submit(room_entity);
+
+                    room_entity->needs_update = true;
+                    return;
+                }
+
+                deque_remove_first(room_entity->walk_list, (void*)&next);
             }
 
-            room_tile *tile_current = room_entity->room->room_map->map[room_entity->position->x][room_entity->position->y];
             room_tile *tile_next = room_entity->room->room_map->map[next->x][next->y];
 
-            tile_current->entity = NULL;
-            tile_next->entity = room_entity;
+            room_map_set_entity(room_entity->room, room_entity->position->x, room_entity->position->y, NULL);
+            room_map_set_entity(room_entity->room, next->x, next->y, room_entity);
 
             next->z = tile_next->tile_height;
 
-            char value[30];
-            sprintf(value, " %i,%i,%.2f", next->x, next->y, next->z);
+            // " x,y,z" for the move status
+            char value[DECIMAL_INT_MAX_LENGTH * 2 + DECIMAL_FIXED_MAX_LENGTH + 4];
+            int length = 0;
+
+            value[length++] = ' ';
+            length += decimal_encode_int(value + length, next->x);
+            value[length++] = ',';
+            length += decimal_encode_int(value + length, next->y);
+            value[length++] = ',';
+            length += decimal_encode_fixed(value + length, next->z);
+            value[length] = '\0';
 
             int rotation = calculate_walk_direction(room_entity->position->x, room_entity->position->y, next->x, next->y);
             coord_set_rotation(room_entity->position, rotation, rotation);
@@ -113,8 +134,12 @@ void process_user(session *player) {
 
             room_user_add_status(room_entity, "mv", value, -1, "", -1, -1);
             room_entity->next = next;
+        } else if (room_entity->path_request != NULL) {
+            // The user asked to walk somewhere else already, that path takes over once found
+            room_entity->is_walking = false;
+            room_user_remove_status(room_entity, "mv");
+            room_user_clear_walk_list(room_entity);
         } else {
-            room_entity->next = NULL;
             room_entity->is_walking = false;
             stop_walking(room_entity, false);
         }
@@ -1,4 +1,3 @@
-typedef struct runnable_s runnable;
 typedef struct room_s room;
 
 void walk_task(room *room);
\ No newline at end of file
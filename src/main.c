@@ -7,20 +7,24 @@
 
 #include "sqlite3.h"
 #include "list.h"
-#include "thpool.h"
 #include "log.h"
 
 #include "server/server_listener.h"
 #include "server/rcon/rcon_listener.h"
 
 #include "communication/message_handler.h"
+#include "communication/messages/packet_registry.h"
+#include "communication/message_stats.h"
 #include "database/db_connection.h"
 
-#include "game/game_thread.h"
 #include "game/player/player.h"
 #include "game/pathfinder/pathfinder.h"
+#include "game/pathfinder/pathfinder_benchmark.h"
 
 #include "util/threading.h"
+#include "util/executor.h"
+#include "util/scheduler.h"
+#include "util/stringbuilder.h"
 #include "util/configuration/configuration.h"
 
 #include "util/encoding/base64encoding.h"
@@ -106,6 +110,7 @@ int main(void) {
     item_manager_init();
     catalogue_manager_init();
     message_handler_init();
+    packet_registry_init();
     create_thread_pool();
 
     /*char **test = malloc(sizeof(char*) * 2);
@@ -114,9 +119,6 @@ int main(void) {
 
     printf("%s, %s\n", test[0], test[1]);*/
 
-    pthread_t game_thread;
-    game_thread_init(&game_thread);
-
     server_settings rcon_settings;// = malloc(sizeof(server_settings));
     strcpy(rcon_settings.ip, configuration_get_string("rcon.ip.address"));
     rcon_settings.port = configuration_get_int("rcon.port");
@@ -172,6 +174,27 @@ bool handle_command(char *command) {
         return false;
     }
 
+    if (strcmp(command, "stats") == 0) {
+        stringbuilder *sb = sb_create();
+        message_stats_append(sb);
+        executor_stats_append(global.thread_manager.executor, sb);
+
+        log_info("Message handler statistics:\n%s", sb->data);
+        sb_cleanup(sb);
+
+        return false;
+    }
+
+    if (strcmp(command, "pathbench") == 0) {
+        stringbuilder *sb = sb_create();
+        pathfinder_benchmark_append(sb);
+
+        log_info("Pathfinder node expansions per model:\n%s", sb->data);
+        sb_cleanup(sb);
+
+        return false;
+    }
+
     if (strcmp(command, "quit") == 0) {
         dispose_program();
         return true;
@@ -195,7 +218,10 @@ void dispose_program() {
     log_info("Shutting down server!");
     global.is_shutdown = true;
 
-    thpool_destroy(global.thread_manager.pool);
+    scheduler_dispose(global.thread_manager.scheduler);
+    global.thread_manager.scheduler = NULL;
+
+    executor_dispose(global.thread_manager.executor);
     player_manager_dispose();
     catalogue_manager_dispose();
     category_manager_dispose();
@@ -204,6 +230,7 @@ void dispose_program() {
     room_manager_dispose();
     model_manager_dispose();
     item_manager_dispose();
+    packet_registry_dispose();
 
     if (sqlite3_close(global.DB) != SQLITE_OK) {
         log_fatal("Could not close SQLite database: %s", sqlite3_errmsg(global.DB));
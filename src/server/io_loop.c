@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "shared.h"
+#include "log.h"
+
+#include "game/player/player.h"
+
+#include "util/buffer_pool.h"
+#include "util/mpsc_queue.h"
+
+#include "server/io_loop.h"
+#include "server/server_listener.h"
+
+io_loop *io_loops = NULL;
+int io_loops_count = 0;
+
+_Thread_local io_loop *current_io_loop = NULL;
+
+/**
+ * Get the amount of event loops the server should run with, every loop gets
+ * its own thread and listening socket.
+ *
+ * @return the amount of loops, at least one
+ */
+int io_loop_configured_count() {
+    int count = configuration_get_int("server.io.threads");
+
+    if (count <= 0) {
+        count = 1;
+    }
+
+#ifndef SO_REUSEPORT
+    if (count > 1) {
+        log_info("SO_REUSEPORT is not supported, running with a single I/O loop");
+        count = 1;
+    }
+#endif
+
+    return count;
+}
+
+/**
+ * Create every event loop and spawn their threads. The kernel spreads incoming
+ * connections over the listening sockets and a session stays on the loop that
+ * accepted it.
+ *
+ * @param settings the server settings
+ * @param first_thread the thread to initialise for the first loop
+ */
+void io_loop_start_all(server_settings *settings, pthread_t *first_thread) {
+    io_loops_count = io_loop_configured_count();
+    io_loops = malloc(sizeof(io_loop) * io_loops_count);
+
+    for (int i = 0; i < io_loops_count; i++) {
+        io_loop *loop = &io_loops[i];
+        loop->id = i;
+        loop->settings = settings;
+        loop->reuse_port = io_loops_count > 1;
+        loop->read_buffers = NULL;
+        loop->flush_mailbox = mpsc_queue_create();
+
+        if (pthread_create(&loop->thread, NULL, &io_loop_run, (void *) loop) != 0) {
+            log_fatal("Uh-oh! Unable to spawn I/O loop thread %i", i);
+        }
+    }
+
+    *first_thread = io_loops[0].thread;
+}
+
+/**
+ * Get the event loop running on the calling thread.
+ *
+ * @return the loop, NULL if not called from an event loop thread
+ */
+io_loop *io_loop_current() {
+    return current_io_loop;
+}
+
+/**
+ * Check if the calling thread is the thread running the given loop.
+ *
+ * @param loop the loop
+ * @return true, if successful
+ */
+bool io_loop_is_current(io_loop *loop) {
+    return current_io_loop == loop;
+}
+
+/**
+ * Hand a session over to its loop to have its send queue flushed. Safe to call
+ * from any thread, the loop is only woken up when called from another thread since
+ * the prepare handle drains the mailbox before the loop polls again. The mailbox
+ * holds a reference to the session until it was flushed.
+ *
+ * @param loop the loop owning the session
+ * @param player the session
+ */
+void io_loop_post_flush(io_loop *loop, session *player) {
+    mpsc_queue_push(loop->flush_mailbox, player_retain(player));
+
+    if (!io_loop_is_current(loop)) {
+        uv_async_send(&loop->flush_async);
+    }
+}
+
+/**
+ * Open the listening socket of the loop. With several loops every socket is bound
+ * to the same address with SO_REUSEPORT.
+ *
+ * @param loop the loop
+ * @return true, if successful
+ */
+bool io_loop_listen(io_loop *loop) {
+    struct sockaddr_in bind_addr;
+    uv_ip4_addr(loop->settings->ip, loop->settings->port, &bind_addr);
+
+    uv_tcp_init(&loop->loop, &loop->server);
+    loop->server.data = loop;
+
+#ifdef SO_REUSEPORT
+    if (loop->reuse_port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        int enabled = 1;
+
+        if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+
+            return false;
+        }
+
+        uv_tcp_open(&loop->server, fd);
+    }
+#endif
+
+    if (uv_tcp_bind(&loop->server, (const struct sockaddr*) &bind_addr, 0) != 0) {
+        return false;
+    }
+
+    return uv_listen((uv_stream_t *) &loop->server, 128, server_on_new_connection) == 0;
+}
+
+/**
+ * Thread callback running a single event loop.
+ *
+ * @param arguments the loop
+ */
+void *io_loop_run(void *arguments) {
+    io_loop *loop = (io_loop *) arguments;
+    current_io_loop = loop;
+
+    uv_loop_init(&loop->loop);
+    loop->loop.data = loop;
+    loop->read_buffers = buffer_pool_create(READ_BUFFER_SIZE + 1, READ_BUFFER_POOL_SIZE);
+
+    uv_prepare_init(&loop->loop, &loop->flush_prepare);
+    loop->flush_prepare.data = loop;
+    uv_prepare_start(&loop->flush_prepare, server_on_flush_prepare);
+
+    uv_async_init(&loop->loop, &loop->flush_async, server_on_flush_async);
+    loop->flush_async.data = loop;
+
+    if (!io_loop_listen(loop)) {
+        log_fatal("Unable to listen on %s:%i for I/O loop %i", loop->settings->ip, loop->settings->port, loop->id);
+        return NULL;
+    }
+
+    uv_run(&loop->loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop->loop);
+
+    buffer_pool_dispose(loop->read_buffers);
+    return NULL;
+}
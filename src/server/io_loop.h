@@ -0,0 +1,34 @@
+#ifndef IO_LOOP_H
+#define IO_LOOP_H
+
+#include <stdbool.h>
+#include <pthread.h>
+#include "uv.h"
+
+typedef struct session_s session;
+typedef struct server_settings_s server_settings;
+typedef struct buffer_pool_s buffer_pool;
+typedef struct mpsc_queue_s mpsc_queue;
+
+typedef struct io_loop_s {
+    int id;
+    uv_loop_t loop;
+    pthread_t thread;
+    uv_tcp_t server;
+    uv_prepare_t flush_prepare;
+    uv_async_t flush_async;
+    buffer_pool *read_buffers;
+    mpsc_queue *flush_mailbox;
+    server_settings *settings;
+    bool reuse_port;
+} io_loop;
+
+int io_loop_configured_count();
+void io_loop_start_all(server_settings *settings, pthread_t *first_thread);
+io_loop *io_loop_current();
+bool io_loop_is_current(io_loop *loop);
+void io_loop_post_flush(io_loop *loop, session *player);
+bool io_loop_listen(io_loop *loop);
+void *io_loop_run(void *arguments);
+
+#endif
@@ -6,13 +6,17 @@
 #include "game/player/player_manager.h"
 #include "game/player/player.h"
 
+#include "communication/message_stats.h"
+#include "util/executor.h"
+#include "util/stringbuilder.h"
+
 #include "shared.h"
 #include "log.h"
 
 void rcon_handle_command(uv_stream_t *handle, int header, char *message) {
     if (header == 1) { // "GET_USERS"
         char users_online[10];
-        sprintf(users_online, "%i", (int) list_size(global.player_manager.players));
+        sprintf(users_online, "%i", player_manager_count());
 
         rcon_send(handle, users_online);
     }
@@ -29,6 +33,16 @@ void rcon_handle_command(uv_stream_t *handle, int header, char *message) {
         }
 
         player_refresh_appearance(p);
+        player_release(p);
+    }
+
+    if (header == 3) { // "GET_STATS"
+        stringbuilder *sb = sb_create();
+        message_stats_append(sb);
+        executor_stats_append(global.thread_manager.executor, sb);
+
+        rcon_send(handle, sb->data);
+        sb_cleanup(sb);
     }
 }
 
@@ -0,0 +1,132 @@
+#include <stdlib.h>
+
+#include "send_queue.h"
+#include "util/shared_buffer.h"
+
+#define SEND_QUEUE_INITIAL_CAPACITY 16
+
+/**
+ * Create an outbound queue for a session. Messages can be queued from any
+ * thread, they're taken off the queue by the event loop owning the session.
+ *
+ * @return the send queue
+ */
+send_queue *send_queue_create() {
+    send_queue *queue = malloc(sizeof(send_queue));
+    pthread_mutex_init(&queue->lock, NULL);
+    queue->buffers = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->pending_bytes = 0;
+    queue->flush_scheduled = false;
+    queue->overflowed = false;
+    queue->close_requested = false;
+    return queue;
+}
+
+/**
+ * Queue a message, the queue takes its own reference to the buffer. The message is
+ * refused once the queued and in flight bytes go over the limit, the queue is then
+ * marked as overflowed so the owner can drop the connection.
+ *
+ * @param queue the send queue
+ * @param buffer the finalised message
+ * @param limit the high-water mark in bytes, 0 for no limit
+ * @param in_flight the amount of bytes already handed to the socket
+ * @return true, if a flush needs to be scheduled for this queue
+ */
+bool send_queue_push(send_queue *queue, shared_buffer *buffer, size_t limit, size_t in_flight) {
+    pthread_mutex_lock(&queue->lock);
+
+    if (queue->overflowed || (limit > 0 && queue->pending_bytes + in_flight + buffer->length > limit)) {
+        queue->overflowed = true;
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+
+    if (queue->count == queue->capacity) {
+        queue->capacity = queue->capacity == 0 ? SEND_QUEUE_INITIAL_CAPACITY : queue->capacity * 2;
+        queue->buffers = realloc(queue->buffers, sizeof(shared_buffer*) * queue->capacity);
+    }
+
+    queue->buffers[queue->count++] = shared_buffer_retain(buffer);
+    queue->pending_bytes += buffer->length;
+
+    bool schedule = !queue->flush_scheduled;
+    queue->flush_scheduled = true;
+
+    pthread_mutex_unlock(&queue->lock);
+    return schedule;
+}
+
+/**
+ * Mark the queue so the owner closes the connection on its next flush.
+ *
+ * @param queue the send queue
+ * @return true, if a flush needs to be scheduled for this queue
+ */
+bool send_queue_close(send_queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+
+    queue->close_requested = true;
+
+    bool schedule = !queue->flush_scheduled;
+    queue->flush_scheduled = true;
+
+    pthread_mutex_unlock(&queue->lock);
+    return schedule;
+}
+
+/**
+ * Take every queued message off the queue, the caller owns the returned references
+ * and has to release them with send_queue_release_buffers.
+ *
+ * @param queue the send queue
+ * @param buffers set to the array of queued buffers
+ * @param overflowed set to whether the high-water mark was hit
+ * @param close_requested set to whether the connection should be closed
+ * @return the amount of buffers taken
+ */
+int send_queue_take(send_queue *queue, shared_buffer ***buffers, bool *overflowed, bool *close_requested) {
+    pthread_mutex_lock(&queue->lock);
+
+    *overflowed = queue->overflowed;
+    *close_requested = queue->close_requested;
+
+    int count = queue->count;
+    *buffers = queue->buffers;
+
+    queue->buffers = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->pending_bytes = 0;
+    queue->flush_scheduled = false;
+
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+/**
+ * Release buffers taken off a send queue.
+ *
+ * @param buffers the buffers
+ * @param count the amount of buffers
+ */
+void send_queue_release_buffers(shared_buffer **buffers, int count) {
+    for (int i = 0; i < count; i++) {
+        shared_buffer_release(buffers[i]);
+    }
+
+    free(buffers);
+}
+
+/**
+ * Cleanup the queue along with any message that was never sent.
+ *
+ * @param queue the send queue
+ */
+void send_queue_dispose(send_queue *queue) {
+    send_queue_release_buffers(queue->buffers, queue->count);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue);
+}
@@ -0,0 +1,27 @@
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+#include <stdbool.h>
+#include <pthread.h>
+
+typedef struct shared_buffer_s shared_buffer;
+
+typedef struct send_queue_s {
+    pthread_mutex_t lock;
+    shared_buffer **buffers;
+    int count;
+    int capacity;
+    size_t pending_bytes;
+    bool flush_scheduled;
+    bool overflowed;
+    bool close_requested;
+} send_queue;
+
+send_queue *send_queue_create();
+bool send_queue_push(send_queue *queue, shared_buffer *buffer, size_t limit, size_t in_flight);
+bool send_queue_close(send_queue *queue);
+int send_queue_take(send_queue *queue, shared_buffer ***buffers, bool *overflowed, bool *close_requested);
+void send_queue_release_buffers(shared_buffer **buffers, int count);
+void send_queue_dispose(send_queue *queue);
+
+#endif
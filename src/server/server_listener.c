@@ -1,31 +1,47 @@
 #include <stdio.h>
 
+#include "list.h"
 #include "hashtable.h"
 #include "shared.h"
 #include "log.h"
 
 #include "game/player/player.h"
 #include "game/player/player_manager.h"
+#include "game/room/room_manager.h"
+#include "game/room/room_user.h"
+#include "game/room/manager/room_entity_manager.h"
 
 #include "communication/message_handler.h"
 
 #include "communication/messages/incoming_message.h"
 #include "communication/messages/outgoing_message.h"
+#include "communication/messages/packet_registry.h"
 
+#include "util/ring_buffer.h"
+#include "util/shared_buffer.h"
+#include "util/buffer_pool.h"
+#include "util/mpsc_queue.h"
+#include "util/actor.h"
 #include "util/encoding/base64encoding.h"
+
+#include "server/send_queue.h"
+#include "server/io_loop.h"
 #include "server/server_listener.h"
 
+size_t send_queue_limit = SEND_QUEUE_LIMIT;
 
 /**
- * Allocate buffer for reading data.
+ * Allocate buffer for reading data, blocks are recycled through the read buffer pool
+ * of the loop instead of being allocated for every read.
  *
  * @param handle the socket that the data is going to
  * @param size the size of the data
  * @param buf the buffer containing the data
  */
 void server_alloc_buffer(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
-    buf->base = malloc(size);
-    buf->len = size;
+    io_loop *loop = handle->loop->data;
+    buf->base = buffer_pool_acquire(loop->read_buffers);
+    buf->len = READ_BUFFER_SIZE;
 }
 
 /**
@@ -38,83 +54,412 @@ void server_on_connection_close(uv_handle_t *handle) {
     player->disconnected = true;
 
     log_info("Client [%s] has disconnected", player->ip_address);
+
+    // Each timer keeps the session alive until libuv is done with it
+    if (player->ping_timer != NULL) {
+        player_retain(player);
+        uv_close((uv_handle_t *) player->ping_timer, server_on_timer_close);
+    }
+
+    if (player->idle_timer != NULL) {
+        player_retain(player);
+        uv_close((uv_handle_t *) player->idle_timer, server_on_timer_close);
+    }
+
     player_cleanup(player);
 }
 
 /**
- * Cleanup buffer after writing data.
+ * Start the ping and room idle timers of a new session on the loop owning it. libuv
+ * keeps the timers of a loop in a min-heap, so only the sessions whose deadline
+ * passed are ever visited.
+ *
+ * @param player the session
+ */
+void server_start_timers(session *player) {
+    player->ping_timer = malloc(sizeof(uv_timer_t));
+    uv_timer_init(&player->io_loop->loop, player->ping_timer);
+    player->ping_timer->data = player;
+    uv_timer_start(player->ping_timer, server_on_ping_timer, PING_INTERVAL_MILLIS, PING_INTERVAL_MILLIS);
+
+    player->idle_timer = malloc(sizeof(uv_timer_t));
+    uv_timer_init(&player->io_loop->loop, player->idle_timer);
+    player->idle_timer->data = player;
+    uv_timer_start(player->idle_timer, server_on_idle_timer, IDLE_CHECK_MAX_MILLIS, 0);
+}
+
+/**
+ * Ping the session, if it didn't answer the previous ping it has timed out.
+ *
+ * @param handle the ping timer
+ */
+void server_on_ping_timer(uv_timer_t *handle) {
+    session *player = handle->data;
+
+    if (player->disconnected) {
+        return;
+    }
+
+    if (player->ping_safe) {
+        player->ping_safe = false;
+
+        player_send_buffer(player, packet_registry_get(PACKET_PING)); // "@r"
+        return;
+    }
+
+    if (player->logged_in) {
+        log_info("Player %s timed out", player->player_data->username);
+    } else {
+        log_info("Connection %s timed out", player->ip_address);
+    }
+
+    player_disconnect(player);
+}
+
+/**
+ * Check the room idle deadline of the session. The deadline is pushed back by the
+ * room actor whenever the user does something, so the timer is only re-armed for
+ * whatever time is left when it fires. Once the deadline passed the room's actor
+ * makes the final call on kicking the user.
+ *
+ * @param handle the idle timer
+ */
+void server_on_idle_timer(uv_timer_t *handle) {
+    session *player = handle->data;
+    uint64_t delay = IDLE_CHECK_MAX_MILLIS;
+
+    if (player->disconnected) {
+        return;
+    }
+
+    if (player->route_room_id > 0 && player->logged_in && player->room_user != NULL) {
+        time_t now = time(NULL);
+        time_t deadline = player->room_user->room_idle_timer;
+
+        if (now > deadline) {
+            if (!room_manager_post(player->route_room_id, room_kick_idle_command, player_retain(player), (actor_release) player_release)) {
+                player_release(player);
+            }
+        } else if ((uint64_t) (deadline - now + 1) * 1000 < delay) {
+            delay = (uint64_t) (deadline - now + 1) * 1000;
+        }
+    }
+
+    uv_timer_start(handle, server_on_idle_timer, delay, 0);
+}
+
+/**
+ * Free a session timer once libuv closed it.
+ *
+ * @param handle the timer
+ */
+void server_on_timer_close(uv_handle_t *handle) {
+    session *player = handle->data;
+    free(handle);
+    player_release(player);
+}
+
+/**
+ * Drop the references held by a write once it completed.
  *
  * @param req the write request buffer
  * @param status the status of the write
  */
 void server_on_write(uv_write_t* req, int status) {
-    free(req->data);
-    free(req);
+    send_request *request = (send_request *) req;
+    send_queue_release_buffers(request->buffers, request->count);
+    free(request);
 }
 
 /**
- * Read incoming data from socket.
+ * Get the maximum amount of bytes a session may have queued or in flight before
+ * it's considered too slow and gets disconnected.
  *
- * @param handle the socket to read from
- * @param nread the amount of bytes read
- * @param buf the buffer containing the data
+ * @return the limit in bytes
  */
-void server_on_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
-    if (nread == UV_EOF) {
-        uv_close((uv_handle_t*) handle, server_on_connection_close);
+size_t server_send_queue_limit() {
+    return send_queue_limit;
+}
+
+/**
+ * Queue the session to have its outbound messages flushed by the loop owning it.
+ * Safe to call from any thread, the session is handed over through the loop's mailbox.
+ *
+ * @param player the session to flush
+ */
+void server_schedule_flush(session *player) {
+    io_loop_post_flush(player->io_loop, player);
+}
+
+/**
+ * Ask the loop owning the session to close its connection. Safe to call from any
+ * thread, the socket is only ever touched by its own loop.
+ *
+ * @param player the session
+ */
+void server_disconnect_session(session *player) {
+    if (send_queue_close(player->send_queue)) {
+        server_schedule_flush(player);
+    }
+}
+
+/**
+ * Write every queued message of the session to the socket with a single vectored
+ * write. A non blocking write is tried first, only what the socket didn't take
+ * right away is queued inside libuv, which keeps the buffers referenced until the
+ * write completes.
+ *
+ * @param player the session to flush
+ */
+void server_flush_session(session *player) {
+    uv_stream_t *stream = player->stream;
+
+    bool overflowed;
+    bool close_requested;
+    shared_buffer **buffers;
+    int count = send_queue_take(player->send_queue, &buffers, &overflowed, &close_requested);
+
+    if (uv_is_closing((uv_handle_t *) stream)) {
+        send_queue_release_buffers(buffers, count);
         return;
     }
 
-    if (nread == 0) {
-        uv_close((uv_handle_t*) handle, server_on_connection_close);
+    if (overflowed) {
+        log_info("Client [%s] is not reading fast enough, disconnecting", player->ip_address);
+        send_queue_release_buffers(buffers, count);
+
+        uv_close((uv_handle_t *) stream, server_on_connection_close);
         return;
     }
 
-    if (nread > 0) {
-        session *player = handle->data;
+    if (close_requested) {
+        send_queue_release_buffers(buffers, count);
+        uv_close((uv_handle_t *) stream, server_on_connection_close);
+        return;
+    }
 
-        if (buf->base == NULL) {
-            player->disconnected = true;
-            return;
-        }
+    if (count == 0) {
+        free(buffers);
+        return;
+    }
+
+    // libuv copies the buffer descriptors, they only have to live for the call
+    uv_buf_t *bufs = malloc(sizeof(uv_buf_t) * count);
 
-        int amount_read = 0;
+    for (int i = 0; i < count; i++) {
+        bufs[i] = uv_buf_init(buffers[i]->data, (unsigned int) buffers[i]->length);
+    }
 
-        while (amount_read < nread) {
-            char recv_length[] = {
-                    buf->base[amount_read++],
-                    buf->base[amount_read++],
-                    buf->base[amount_read++],
-                    '\0'
-            };
+    int written = uv_try_write(stream, bufs, (unsigned int) count);
 
-            int message_length = base64_decode(recv_length) + 1;
+    if (written < 0) {
+        written = 0; // Either UV_EAGAIN or an error, which uv_write will report too
+    }
 
-            if (message_length < 0 || message_length > 5120) {
-                continue;
-            }
+    int index = 0;
+    size_t remaining = (size_t) written;
 
-            char *message = malloc(message_length * sizeof(char));
+    while (index < count && remaining >= bufs[index].len) {
+        remaining -= bufs[index].len;
+        index++;
+    }
 
-            for (int i = 0; i < message_length - 1; i++) {
-                message[i] = buf->base[amount_read++];
-            }
+    if (index == count) {
+        free(bufs);
+        send_queue_release_buffers(buffers, count);
+        return;
+    }
+
+    send_request *request = malloc(sizeof(send_request));
+    request->buffers = buffers;
+    request->count = count;
 
-            message[message_length - 1] = '\0';
+    bufs[index].base += remaining;
+    bufs[index].len -= remaining;
 
-            if (player != NULL) {
-                incoming_message *im = im_create(message);
-                message_handler_invoke(im, player);
-                im_cleanup(im);
+    if (uv_write(&request->req, stream, bufs + index, (unsigned int) (count - index), server_on_write) != 0) {
+        server_on_write(&request->req, -1);
+    }
+
+    free(bufs);
+}
+
+/**
+ * Flush every session that was handed to the loop since the last flush, dropping the
+ * reference the mailbox held.
+ *
+ * @param loop the loop to flush
+ */
+void server_flush_pending(io_loop *loop) {
+    void *value;
+
+    while (mpsc_queue_pop(loop->flush_mailbox, &value)) {
+        session *player = value;
+        server_flush_session(player);
+        player_release(player);
+    }
+}
+
+/**
+ * Called once per loop iteration, right before the loop polls for I/O.
+ *
+ * @param handle the prepare handle
+ */
+void server_on_flush_prepare(uv_prepare_t *handle) {
+    server_flush_pending(handle->data);
+}
+
+/**
+ * Called when another thread handed sessions to the loop.
+ *
+ * @param handle the async handle
+ */
+void server_on_flush_async(uv_async_t *handle) {
+    server_flush_pending(handle->data);
+}
+
+/**
+ * Decode the B64 length prefix of a frame.
+ *
+ * @param data the first three bytes of the frame
+ * @return the length of the frame body
+ */
+int server_frame_length(const char *data) {
+    return base64_decode_length(data, 3);
+}
+
+/**
+ * Dispatch a single complete frame to the message handler, the incoming message
+ * is a view over the frame. The frame is terminated in place and the byte after
+ * the frame is restored afterwards, callers must guarantee that byte is addressable.
+ *
+ * @param player the session the frame belongs to
+ * @param frame the frame body, without the length prefix
+ * @param length the length of the frame body
+ */
+void server_dispatch_frame(session *player, char *frame, int length) {
+    if (length < 2) {
+        return; // Not even a header, nothing to process
+    }
+
+    char terminator = frame[length];
+    frame[length] = '\0';
+
+    incoming_message im;
+    im_init(&im, frame, length);
+    message_handler_invoke(&im, player);
+
+    frame[length] = terminator;
+}
+
+/**
+ * Parse frames out of the received data. A frame that was split over several reads is
+ * reassembled in the session's receive buffer, complete frames are handled straight out
+ * of the read buffer without being copied.
+ *
+ * @param handle the socket the data was read from
+ * @param player the session the data belongs to
+ * @param data the data that was read
+ * @param nread the amount of bytes read
+ * @return false if the client sent a malformed frame
+ */
+bool server_process_frames(uv_stream_t *handle, session *player, char *data, size_t nread) {
+    ring_buffer *pending = player->receive_buffer;
+    size_t offset = 0;
+
+    // Finish the frame that was left incomplete by the previous read
+    while (ring_buffer_size(pending) > 0 && offset < nread && !uv_is_closing((uv_handle_t *) handle)) {
+        size_t buffered = ring_buffer_size(pending);
+
+        if (buffered < 3) {
+            size_t amount = 3 - buffered;
+
+            if (amount > nread - offset) {
+                amount = nread - offset;
             }
 
-            free(message);
+            ring_buffer_write(pending, data + offset, amount);
+            offset += amount;
+            continue;
+        }
+
+        char prefix[3];
+        ring_buffer_peek(pending, prefix, 3);
+
+        int message_length = server_frame_length(prefix);
+
+        if (message_length < 0 || message_length > MAX_MESSAGE_LENGTH) {
+            return false;
+        }
+
+        size_t frame_length = (size_t) message_length + 3;
+        size_t amount = frame_length - buffered;
+
+        if (amount > nread - offset) {
+            amount = nread - offset;
+        }
+
+        ring_buffer_write(pending, data + offset, amount);
+        offset += amount;
+
+        if (ring_buffer_size(pending) == frame_length) {
+            char *frame = ring_buffer_linearise(pending);
+            server_dispatch_frame(player, frame + 3, message_length);
+            ring_buffer_clear(pending);
         }
-    } else {
-        uv_close((uv_handle_t *) handle, server_on_connection_close);
     }
 
-    free(buf->base);
+    // Handle every complete frame in place
+    while (nread - offset >= 3 && !uv_is_closing((uv_handle_t *) handle)) {
+        int message_length = server_frame_length(data + offset);
+
+        if (message_length < 0 || message_length > MAX_MESSAGE_LENGTH) {
+            return false;
+        }
+
+        if (nread - offset < (size_t) message_length + 3) {
+            break;
+        }
+
+        server_dispatch_frame(player, data + offset + 3, message_length);
+        offset += message_length + 3;
+    }
+
+    // Keep whatever is left for the next read
+    if (offset < nread) {
+        ring_buffer_write(pending, data + offset, nread - offset);
+    }
+
+    return true;
+}
+
+/**
+ * Read incoming data from socket.
+ *
+ * @param handle the socket to read from
+ * @param nread the amount of bytes read
+ * @param buf the buffer containing the data
+ */
+void server_on_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf) {
+    if (nread < 0) {
+        if (!uv_is_closing((uv_handle_t *) handle)) {
+            uv_close((uv_handle_t *) handle, server_on_connection_close);
+        }
+    } else if (nread > 0 && buf->base != NULL) {
+        session *player = handle->data;
+
+        if (player != NULL && !server_process_frames(handle, player, buf->base, (size_t) nread)) {
+            log_info("Client [%s] sent a malformed message", player->ip_address);
+
+            if (!uv_is_closing((uv_handle_t *) handle)) {
+                uv_close((uv_handle_t *) handle, server_on_connection_close);
+            }
+        }
+    }
+
+    // A read of zero bytes is not an error, libuv just had nothing for us
+    io_loop *loop = handle->loop->data;
+    buffer_pool_release(loop->read_buffers, buf->base);
 }
 
 /**
@@ -128,8 +473,10 @@ void server_on_new_connection(uv_stream_t *server, int status) {
         return;
     }
 
+    io_loop *loop = server->data;
+
     uv_tcp_t *client = malloc(sizeof(uv_tcp_t));
-    uv_tcp_init(uv_default_loop(), client);
+    uv_tcp_init(&loop->loop, client);
 
     struct sockaddr_in client_addr;
     int client_addr_length;
@@ -141,16 +488,16 @@ void server_on_new_connection(uv_stream_t *server, int status) {
     uv_inet_ntop(AF_INET, &client_addr.sin_addr, ip, sizeof(ip));
 
     session *p = player_manager_add(handle, ip);
+    p->io_loop = loop;
     client->data = p;
 
-    log_info("Client [%s] has connected", p->ip_address);
+    log_info("Client [%s] has connected on loop %i", p->ip_address, loop->id);
     int result = uv_accept(server, handle);
 
     if(result == 0) {
-        outgoing_message *msg = om_create(0); // "@@"
-        player_send(p, msg);
-        om_cleanup(msg);
+        player_send_buffer(p, packet_registry_get(PACKET_HELLO)); // "@@"
 
+        server_start_timers(p);
         uv_read_start(handle, server_alloc_buffer, server_on_read);
     } else {
         uv_close((uv_handle_t *) handle, server_on_connection_close);
@@ -158,40 +505,18 @@ void server_on_new_connection(uv_stream_t *server, int status) {
 }
 
 /**
- * Thread callback to start server on a different loop.
- *
- * @param arguments the server settings argument
- */
-void *listen_server(void *arguments)  {
-    server_settings *args = (server_settings *)arguments;
-    uv_loop_t *loop = uv_default_loop();
-
-    uv_tcp_t server;
-    struct sockaddr_in bind_addr;
-
-    uv_tcp_init(loop, &server);
-    uv_ip4_addr(args->ip, args->port, &bind_addr);
-    uv_tcp_bind(&server, (const struct sockaddr*) &bind_addr, 0);
-    uv_listen((uv_stream_t *) &server, 128, server_on_new_connection);
-
-    uv_run(loop, UV_RUN_DEFAULT);
-    uv_loop_close(loop);
-
-    return NULL;
-}
-
-/**
- * Create thread for server listener.
+ * Start the event loops of the server, each on their own thread.
  *
  * @param settings the server settings
- * @param server_thread the thread to initialise
+ * @param server_thread the thread to initialise with the first loop's thread
  */
 void start_server(server_settings *settings, pthread_t *server_thread) {
     log_info("Starting server on port %i...", settings->port);
 
-    if (pthread_create(server_thread, NULL, &listen_server, (void*) settings) != 0) {
-        log_fatal("Uh-oh! Unable to spawn server thread");
-    } else {
-        log_info("Server successfully started!", settings->port);
+    if (configuration_get_int("server.send.queue.limit") > 0) {
+        send_queue_limit = (size_t) configuration_get_int("server.send.queue.limit");
     }
+
+    io_loop_start_all(settings, server_thread);
+    log_info("Server successfully started with %i I/O loop(s)!", io_loop_configured_count());
 }
\ No newline at end of file
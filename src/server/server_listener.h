@@ -1,18 +1,50 @@
 #ifndef SERVER_LISTENER_H
 #define SERVER_LISTENER_H
 
+#include <stdbool.h>
 #include "uv.h"
 
+#define RECEIVE_BUFFER_SIZE 8192
+#define READ_BUFFER_SIZE 65536
+#define READ_BUFFER_POOL_SIZE 8
+#define SEND_QUEUE_LIMIT (1024 * 1024)
+#define PING_INTERVAL_MILLIS 60000
+#define IDLE_CHECK_MAX_MILLIS 60000
+
+typedef struct session_s session;
+typedef struct shared_buffer_s shared_buffer;
+typedef struct io_loop_s io_loop;
+
+typedef struct send_request_s {
+    uv_write_t req;
+    shared_buffer **buffers;
+    int count;
+} send_request;
+
 typedef struct server_settings_s {
     char ip[255];
     int port;
 } server_settings;
 
 void server_on_new_connection(uv_stream_t *server, int status);
+int server_frame_length(const char *data);
+void server_dispatch_frame(session *player, char *frame, int length);
+bool server_process_frames(uv_stream_t *handle, session *player, char *data, size_t nread);
 void server_on_read(uv_stream_t *handle, ssize_t nread, const uv_buf_t *buf);
 void server_alloc_buffer(uv_handle_t* handle, size_t  size, uv_buf_t* buf);
 void server_on_connection_close(uv_handle_t *handle);
+void server_start_timers(session *player);
+void server_on_ping_timer(uv_timer_t *handle);
+void server_on_idle_timer(uv_timer_t *handle);
+void server_on_timer_close(uv_handle_t *handle);
 void server_on_write(uv_write_t* req, int status);
+size_t server_send_queue_limit();
+void server_schedule_flush(session *player);
+void server_disconnect_session(session *player);
+void server_flush_session(session *player);
+void server_flush_pending(io_loop *loop);
+void server_on_flush_prepare(uv_prepare_t *handle);
+void server_on_flush_async(uv_async_t *handle);
 void start_server(server_settings *settings, pthread_t *server_thread);
 
 #endif
\ No newline at end of file
@@ -238,7 +238,7 @@ int get_name_check_code(char *username) {
         return AARON_IS_A_FAG;
     }
 
-    if (strlen(username) > 15 || !has_allowed_characters(username, "1234567890qwertyuiopasdfghjklzxcvbnm-+=?!@:.,$")) {
+    if (strlen(username) > MAX_USERNAME_LENGTH || !has_allowed_characters(username, "1234567890qwertyuiopasdfghjklzxcvbnm-+=?!@:.,$")) {
         return 2;
     } else {
         if (player_query_exists_username(username)) {
@@ -21,6 +21,7 @@
 #include "uv.h"
 
 #define PREFIX "Kepler"
+#define MAX_USERNAME_LENGTH 15
 #define AARON_IS_A_FAG 8934
 
 typedef struct sqlite3 sqlite3;
@@ -0,0 +1,230 @@
+#include <stdlib.h>
+
+#include "executor.h"
+#include "shared.h"
+
+#include "util/actor.h"
+#include "util/mpsc_queue.h"
+
+#define ACTOR_GATE_CLOSED 0
+#define ACTOR_GATE_OPEN 1
+#define ACTOR_GATE_WAITING 2
+
+/**
+ * Create an actor owning the given state. Messages posted to the actor are run one
+ * at a time on the thread pool in the order they were posted, so the state is only
+ * ever touched by one thread at a time without any locking.
+ *
+ * @param state the state handed to every message
+ * @return the actor
+ */
+actor *actor_create(void *state) {
+    actor *instance = malloc(sizeof(actor));
+    instance->mailbox = mpsc_queue_create();
+    instance->parked = NULL;
+    instance->state = state;
+    atomic_init(&instance->scheduled, false);
+    atomic_init(&instance->disposed, false);
+    atomic_init(&instance->references, 1);
+    return instance;
+}
+
+/**
+ * Post a message to the actor, safe to call from any thread.
+ *
+ * @param actor the actor
+ * @param callback the callback run by the actor with its state
+ * @param argument the argument of the callback
+ * @param release called once the message was handled or dropped, may be NULL
+ */
+void actor_post(actor *actor, actor_callback callback, void *argument, actor_release release) {
+    actor_post_after(actor, NULL, callback, argument, release);
+}
+
+/**
+ * Post a message that may only run once the gate was opened, every message posted
+ * after it waits as well.
+ *
+ * @param actor the actor
+ * @param gate the gate to wait for, NULL to run straight away
+ * @param callback the callback run by the actor with its state
+ * @param argument the argument of the callback
+ * @param release called once the message was handled or dropped, may be NULL
+ */
+void actor_post_after(actor *actor, actor_gate *gate, actor_callback callback, void *argument, actor_release release) {
+    actor_message *message = malloc(sizeof(actor_message));
+    message->callback = callback;
+    message->release = release;
+    message->argument = argument;
+    message->gate = gate;
+
+    mpsc_queue_push(actor->mailbox, message);
+    actor_schedule(actor);
+}
+
+/**
+ * Hand the actor to the thread pool if it isn't already scheduled, the scheduled
+ * run holds its own reference to the actor.
+ *
+ * @param actor the actor
+ */
+void actor_schedule(actor *actor) {
+    if (atomic_exchange(&actor->scheduled, true)) {
+        return;
+    }
+
+    actor_retain(actor);
+    executor_submit(global.thread_manager.executor, (executor_task) actor_run, actor);
+}
+
+/**
+ * Run a batch of messages of the actor. A message waiting for a closed gate parks
+ * the actor, it stays scheduled until the gate opens and schedules it again.
+ *
+ * @param actor the actor
+ */
+void actor_run(actor *actor) {
+    for (int i = 0; i < ACTOR_BATCH_SIZE; i++) {
+        actor_message *message = actor->parked;
+        actor->parked = NULL;
+
+        if (message == NULL && !mpsc_queue_pop(actor->mailbox, (void *) &message)) {
+            break;
+        }
+
+        if (message->gate != NULL && !atomic_load(&actor->disposed) && !actor_gate_park(message->gate, actor)) {
+            actor->parked = message;
+            return;
+        }
+
+        actor_deliver(actor, message);
+    }
+
+    atomic_store(&actor->scheduled, false);
+
+    // Messages posted while the flag was still set would otherwise be left behind
+    if (!mpsc_queue_empty(actor->mailbox) && !atomic_exchange(&actor->scheduled, true)) {
+        executor_submit(global.thread_manager.executor, (executor_task) actor_run, actor);
+        return;
+    }
+
+    actor_release_reference(actor);
+}
+
+/**
+ * Run a single message and release it, the callback is skipped once the actor
+ * was disposed since its state is gone.
+ *
+ * @param actor the actor
+ * @param message the message
+ */
+void actor_deliver(actor *actor, actor_message *message) {
+    if (!atomic_load(&actor->disposed)) {
+        message->callback(actor->state, message->argument);
+    }
+
+    if (message->release != NULL) {
+        message->release(message->argument);
+    }
+
+    if (message->gate != NULL) {
+        actor_gate_release(message->gate);
+    }
+
+    free(message);
+}
+
+/**
+ * Take a reference to the actor.
+ *
+ * @param actor the actor
+ */
+void actor_retain(actor *actor) {
+    atomic_fetch_add_explicit(&actor->references, 1, memory_order_relaxed);
+}
+
+/**
+ * Drop a reference to the actor, the last reference drops every message that
+ * was never run and frees the actor.
+ *
+ * @param actor the actor
+ */
+void actor_release_reference(actor *actor) {
+    if (atomic_fetch_sub_explicit(&actor->references, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    actor_message *message;
+
+    while (mpsc_queue_pop(actor->mailbox, (void *) &message)) {
+        actor_deliver(actor, message);
+    }
+
+    mpsc_queue_dispose(actor->mailbox);
+    free(actor);
+}
+
+/**
+ * Dispose the actor, called by the owner of the state once the state is freed.
+ * Messages still queued are released without being run.
+ *
+ * @param actor the actor
+ */
+void actor_dispose(actor *actor) {
+    atomic_store(&actor->disposed, true);
+    actor->state = NULL;
+    actor_release_reference(actor);
+}
+
+/**
+ * Create a gate that holds back an actor until it's opened, the gate is
+ * referenced by the opener and by the message waiting for it.
+ *
+ * @return the gate
+ */
+actor_gate *actor_gate_create() {
+    actor_gate *gate = malloc(sizeof(actor_gate));
+    atomic_init(&gate->state, ACTOR_GATE_CLOSED);
+    atomic_init(&gate->references, 2);
+    gate->waiting = NULL;
+    return gate;
+}
+
+/**
+ * Register the actor as waiting on the gate.
+ *
+ * @param gate the gate
+ * @param actor the actor running into the gate
+ * @return true, if the gate was already open and the actor can carry on
+ */
+bool actor_gate_park(actor_gate *gate, actor *actor) {
+    int expected = ACTOR_GATE_CLOSED;
+    gate->waiting = actor;
+
+    return !atomic_compare_exchange_strong(&gate->state, &expected, ACTOR_GATE_WAITING);
+}
+
+/**
+ * Open the gate and drop the opener's reference, an actor parked on the gate is
+ * handed back to the thread pool.
+ *
+ * @param gate the gate
+ */
+void actor_gate_open(actor_gate *gate) {
+    if (atomic_exchange(&gate->state, ACTOR_GATE_OPEN) == ACTOR_GATE_WAITING) {
+        executor_submit(global.thread_manager.executor, (executor_task) actor_run, gate->waiting);
+    }
+
+    actor_gate_release(gate);
+}
+
+/**
+ * Drop a reference to the gate.
+ *
+ * @param gate the gate
+ */
+void actor_gate_release(actor_gate *gate) {
+    if (atomic_fetch_sub_explicit(&gate->references, 1, memory_order_acq_rel) == 1) {
+        free(gate);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ACTOR_H
+#define ACTOR_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define ACTOR_BATCH_SIZE 64
+
+typedef struct mpsc_queue_s mpsc_queue;
+typedef struct actor_s actor;
+
+typedef void (*actor_callback)(void *state, void *argument);
+typedef void (*actor_release)(void *argument);
+
+typedef struct actor_gate_s {
+    atomic_int state;
+    atomic_int references;
+    actor *waiting;
+} actor_gate;
+
+typedef struct actor_message_s {
+    actor_callback callback;
+    actor_release release;
+    void *argument;
+    actor_gate *gate;
+} actor_message;
+
+typedef struct actor_s {
+    mpsc_queue *mailbox;
+    atomic_bool scheduled;
+    atomic_bool disposed;
+    atomic_int references;
+    actor_message *parked;
+    void *state;
+} actor;
+
+actor *actor_create(void *state);
+void actor_post(actor *actor, actor_callback callback, void *argument, actor_release release);
+void actor_post_after(actor *actor, actor_gate *gate, actor_callback callback, void *argument, actor_release release);
+void actor_schedule(actor *actor);
+void actor_run(actor *actor);
+void actor_deliver(actor *actor, actor_message *message);
+void actor_retain(actor *actor);
+void actor_release_reference(actor *actor);
+void actor_dispose(actor *actor);
+actor_gate *actor_gate_create();
+bool actor_gate_park(actor_gate *gate, actor *actor);
+void actor_gate_open(actor_gate *gate);
+void actor_gate_release(actor_gate *gate);
+
+#endif
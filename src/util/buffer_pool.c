@@ -0,0 +1,66 @@
+#include <stdlib.h>
+
+#include "buffer_pool.h"
+
+/**
+ * Create a pool of equally sized blocks. The pool is not thread safe, each
+ * event loop should own its own pool.
+ *
+ * @param block_size the size of every block handed out
+ * @param max_blocks the maximum amount of idle blocks to keep around
+ * @return the buffer pool
+ */
+buffer_pool *buffer_pool_create(size_t block_size, int max_blocks) {
+    buffer_pool *pool = malloc(sizeof(buffer_pool));
+    pool->blocks = malloc(sizeof(char*) * max_blocks);
+    pool->count = 0;
+    pool->max_blocks = max_blocks;
+    pool->block_size = block_size;
+    return pool;
+}
+
+/**
+ * Take a block from the pool, a new block is allocated if the pool is empty.
+ *
+ * @param pool the buffer pool
+ * @return the block, it holds block_size bytes
+ */
+char *buffer_pool_acquire(buffer_pool *pool) {
+    if (pool->count > 0) {
+        return pool->blocks[--pool->count];
+    }
+
+    return malloc(pool->block_size);
+}
+
+/**
+ * Give a block back to the pool, it's freed if the pool is already full.
+ *
+ * @param pool the buffer pool
+ * @param block the block to return
+ */
+void buffer_pool_release(buffer_pool *pool, char *block) {
+    if (block == NULL) {
+        return;
+    }
+
+    if (pool->count < pool->max_blocks) {
+        pool->blocks[pool->count++] = block;
+    } else {
+        free(block);
+    }
+}
+
+/**
+ * Cleanup the pool and every idle block it holds.
+ *
+ * @param pool the buffer pool
+ */
+void buffer_pool_dispose(buffer_pool *pool) {
+    for (int i = 0; i < pool->count; i++) {
+        free(pool->blocks[i]);
+    }
+
+    free(pool->blocks);
+    free(pool);
+}
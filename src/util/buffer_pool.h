@@ -0,0 +1,18 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <stddef.h>
+
+typedef struct buffer_pool_s {
+    char **blocks;
+    int count;
+    int max_blocks;
+    size_t block_size;
+} buffer_pool;
+
+buffer_pool *buffer_pool_create(size_t block_size, int max_blocks);
+char *buffer_pool_acquire(buffer_pool *pool);
+void buffer_pool_release(buffer_pool *pool, char *block);
+void buffer_pool_dispose(buffer_pool *pool);
+
+#endif
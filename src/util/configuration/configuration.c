@@ -26,6 +26,8 @@ void configuration_init() {
     if (file != NULL) {
         fclose(file);
     }
+
+    global.configuration.debug = configuration_get_bool("debug");
 }
 
 /**
@@ -40,6 +42,8 @@ void configuration_new() {
     fprintf(fp, "[Server]\n");
     fprintf(fp, "server.ip.address=%s\n", "127.0.0.1");
     fprintf(fp, "server.port=%i\n", 12321);
+    fprintf(fp, "server.send.queue.limit=%i\n", 1048576);
+    fprintf(fp, "server.io.threads=%i\n", 1);
     fprintf(fp, "\n");
     fprintf(fp, "[Rcon]\n");
     fprintf(fp, "rcon.ip.address=%s\n", "127.0.0.1");
@@ -55,6 +59,12 @@ void configuration_new() {
     fprintf(fp, "# 1 tick = 500ms, 6 is 3 seconds\n");
     fprintf(fp, "roller.tick.default=%s\n", "6");
     fprintf(fp, "\n");
+    fprintf(fp, "# 0 = one worker per core\n");
+    fprintf(fp, "executor.threads=%i\n", 0);
+    fprintf(fp, "\n");
+    fprintf(fp, "# Models that pathfind with jump point search, compare with the pathbench command\n");
+    fprintf(fp, "pathfinder.jump.point.models=%s\n", "pool_a,pool_b,park_a,park_b,picnic,sunset_cafe,floatinggarden,gardens,sun_terrace,club_mammoth");
+    fprintf(fp, "\n");
     fprintf(fp, "[Console]\n");
     fprintf(fp, "debug=%s\n", "false");
     fclose(fp);
@@ -5,6 +5,7 @@ typedef struct hashtable_s HashTable;
 
 struct configuration {
     HashTable *entries;
+    bool debug; // cached, it's checked for every packet
 };
 
 void configuration_init();
@@ -1,28 +1,51 @@
 #include "shared.h"
 #include "base64encoding.h"
 
+/**
+ * Decode a zero terminated B64 value.
+ *
+ * @param value the B64 characters
+ * @return the decoded value
+ */
 int base64_decode(char *value) {
+    return base64_decode_length(value, (int) strlen(value));
+}
+
+/**
+ * Decode a B64 value of a known length, the characters don't have to be terminated.
+ *
+ * @param value the B64 characters
+ * @param length the amount of characters
+ * @return the decoded value
+ */
+int base64_decode_length(const char *value, int length) {
     int result = 0;
 
-    for (int i = 0; i < strlen(value); i++) {
-        result += ((value[i] - 0x40) << 6 * (strlen(value) - 1 - i));
+    for (int i = 0; i < length; i++) {
+        result = result * 64 + ((signed char) value[i] - 0x40);
     }
 
     return result;
 }
 
-
 char *base64_encode(int value, int length) {
     char *encoded = malloc(length + 1 *sizeof(char));
+    base64_encode_into(encoded, value, length);
 
-    int slot = 0;
-    int sub_value;
+    encoded[length] = '\0';
+    return encoded;
+}
 
-    for (int i = 0; i < length; i++) {
-        sub_value = (value >> 6 * (length - 1 - i)) & 0x3f;
-        encoded[slot++] = (char) (sub_value + 0x40);
+/**
+ * Encode a B64 integer into a buffer of at least length bytes, no terminator is written.
+ *
+ * @param encoded the buffer to write to
+ * @param value the value to encode
+ * @param length the amount of characters to encode into
+ */
+void base64_encode_into(char *encoded, int value, int length) {
+    for (int i = length - 1; i >= 0; i--) {
+        encoded[i] = (char) ((value & 0x3f) + 0x40);
+        value >>= 6;
     }
-
-    encoded[2] = '\0';
-    return encoded;
-}
\ No newline at end of file
+}
@@ -2,5 +2,7 @@
 #define BASE64ENCODING_H
 
 int base64_decode(char*);
+int base64_decode_length(const char*, int);
 char *base64_encode(int, int);
-#endif
\ No newline at end of file
+void base64_encode_into(char*, int, int);
+#endif
@@ -0,0 +1,105 @@
+#include "shared.h"
+#include "decimalencoding.h"
+
+// Every number from 00 to 99 as two characters, so digits can be written in pairs
+static const char decimal_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Write the digits of an unsigned number, most significant first.
+ *
+ * @param buffer the buffer to write into
+ * @param value the number
+ * @return the amount of characters written
+ */
+static int decimal_encode_unsigned(char *buffer, unsigned long long value) {
+    char digits[20];
+    int position = sizeof(digits);
+
+    while (value >= 100) {
+        unsigned int pair = (unsigned int) (value % 100) * 2;
+        value /= 100;
+
+        digits[--position] = decimal_digit_pairs[pair + 1];
+        digits[--position] = decimal_digit_pairs[pair];
+    }
+
+    if (value >= 10) {
+        unsigned int pair = (unsigned int) value * 2;
+        digits[--position] = decimal_digit_pairs[pair + 1];
+        digits[--position] = decimal_digit_pairs[pair];
+    } else {
+        digits[--position] = (char) ('0' + value);
+    }
+
+    int length = (int) sizeof(digits) - position;
+    memcpy(buffer, digits + position, (size_t) length);
+
+    return length;
+}
+
+/**
+ * Write an integer as decimal text, the same output as printf's "%i" without the
+ * format parsing. The buffer needs room for DECIMAL_INT_MAX_LENGTH characters and
+ * is not zero terminated.
+ *
+ * @param buffer the buffer to write into
+ * @param value the integer
+ * @return the amount of characters written
+ */
+int decimal_encode_int(char *buffer, int value) {
+    if (value < 0) {
+        buffer[0] = '-';
+        return 1 + decimal_encode_unsigned(buffer + 1, 0ULL - (unsigned long long) value);
+    }
+
+    return decimal_encode_unsigned(buffer, (unsigned long long) value);
+}
+
+/**
+ * Write a number with two decimals, like printf's "%.2f" for the heights sent in
+ * status and roller packets. The value is rounded to the nearest hundredth with halves
+ * rounded away from zero, values too large to ever be a height are clamped. The buffer
+ * needs room for DECIMAL_FIXED_MAX_LENGTH characters and is not zero terminated.
+ *
+ * @param buffer the buffer to write into
+ * @param value the number
+ * @return the amount of characters written
+ */
+int decimal_encode_fixed(char *buffer, double value) {
+    double scaled = value * 100;
+    long long hundredths = 0;
+
+    if (scaled >= DECIMAL_FIXED_LIMIT) {
+        hundredths = (long long) DECIMAL_FIXED_LIMIT;
+    } else if (scaled <= -DECIMAL_FIXED_LIMIT) {
+        hundredths = -(long long) DECIMAL_FIXED_LIMIT;
+    } else if (scaled == scaled) {
+        hundredths = (long long) (scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+
+    int length = 0;
+
+    if (hundredths < 0) {
+        buffer[length++] = '-';
+        hundredths = -hundredths;
+    }
+
+    length += decimal_encode_unsigned(buffer + length, (unsigned long long) (hundredths / 100));
+
+    unsigned int pair = (unsigned int) (hundredths % 100) * 2;
+    buffer[length++] = '.';
+    buffer[length++] = decimal_digit_pairs[pair];
+    buffer[length++] = decimal_digit_pairs[pair + 1];
+
+    return length;
+}
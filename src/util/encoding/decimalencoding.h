@@ -0,0 +1,10 @@
+#ifndef DECIMALENCODING_H
+#define DECIMALENCODING_H
+
+#define DECIMAL_INT_MAX_LENGTH 11
+#define DECIMAL_FIXED_MAX_LENGTH 21 // sign, 16 digits, point and two decimals
+#define DECIMAL_FIXED_LIMIT 1e17
+
+int decimal_encode_int(char*, int);
+int decimal_encode_fixed(char*, double);
+#endif
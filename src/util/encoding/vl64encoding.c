@@ -1,6 +1,17 @@
 #include "shared.h"
 #include "vl64encoding.h"
 
+// The amount of bytes needed for an absolute value of the given bit length, the first
+// byte holds two bits of the value and every byte after it six more
+static const unsigned char vl64_byte_counts[33] = {
+    1, 1, 1,
+    2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6
+};
+
 int vl64_decode(const char *value, int *total_bytes) {
     int result;
 
@@ -23,25 +34,66 @@ int vl64_decode(const char *value, int *total_bytes) {
 }
 
 char *vl64_encode(int value) {
-    char encoded[6];
-    char byte_count = 1;
-    int absolute_value = abs(value);
+    char encoded[VL64_MAX_LENGTH];
+    int byte_count = vl64_encode_into(encoded, value);
+
+    char *str = malloc(byte_count + 1 *sizeof(char));
+    memcpy(str, encoded, (size_t) byte_count);
+
+    str[byte_count] = '\0';
+    return str;
+}
 
-    encoded[0] = (char) (0x40 + (absolute_value & 3));
-    encoded[0] |= value < 0 ? 4 : 0;
+/**
+ * Encode a VL64 integer into a buffer of at least VL64_MAX_LENGTH bytes, no terminator
+ * is written.
+ *
+ * @param encoded the buffer to write to
+ * @param value the value to encode
+ * @return the amount of bytes written
+ */
+int vl64_encode_into(char *encoded, int value) {
+    unsigned int absolute_value = value < 0 ? -(unsigned int) value : (unsigned int) value;
+    int byte_count = vl64_encoded_length(value);
 
-    for (absolute_value >>= 2; absolute_value != 0; absolute_value >>= 6) {
-        encoded[byte_count++] = (char) (0x40 + (absolute_value & 0x3f));
+    encoded[0] = (char) (0x40 | (byte_count << 3) | (value < 0 ? 4 : 0) | (absolute_value & 3));
+    absolute_value >>= 2;
+
+    for (int i = 1; i < byte_count; i++) {
+        encoded[i] = (char) (0x40 | (absolute_value & 0x3f));
+        absolute_value >>= 6;
     }
 
-    encoded[0] |= byte_count << 3;
+    return byte_count;
+}
 
-    char *str = malloc(byte_count + 1 *sizeof(char));
+/**
+ * Get the amount of bytes a VL64 integer takes once encoded.
+ *
+ * @param value the value
+ * @return the amount of bytes
+ */
+int vl64_encoded_length(int value) {
+    unsigned int absolute_value = value < 0 ? -(unsigned int) value : (unsigned int) value;
+    int bits = absolute_value == 0 ? 0 : 32 - __builtin_clz(absolute_value);
+    return vl64_byte_counts[bits];
+}
 
-    for (int i = 0; i < byte_count; i++) {
-        str[i] = encoded[i];
+/**
+ * Encode several VL64 integers back to back into a buffer of at least
+ * count * VL64_MAX_LENGTH bytes, no terminator is written.
+ *
+ * @param encoded the buffer to write to
+ * @param values the values to encode
+ * @param count the amount of values
+ * @return the amount of bytes written
+ */
+int vl64_encode_many(char *encoded, const int *values, int count) {
+    int length = 0;
+
+    for (int i = 0; i < count; i++) {
+        length += vl64_encode_into(encoded + length, values[i]);
     }
 
-    str[byte_count] = '\0';
-    return str;
+    return length;
 }
\ No newline at end of file
@@ -1,6 +1,11 @@
 #ifndef VL64ENCODING_H
 #define VL64ENCODING_H
 
+#define VL64_MAX_LENGTH 6
+
 int vl64_decode(const char*, int*);
 char *vl64_encode(int);
-#endif
\ No newline at end of file
+int vl64_encode_into(char*, int);
+int vl64_encoded_length(int);
+int vl64_encode_many(char*, const int*, int);
+#endif
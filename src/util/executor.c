@@ -0,0 +1,292 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "log.h"
+#include "executor.h"
+#include "stringbuilder.h"
+
+_Thread_local executor_worker *current_worker = NULL;
+
+/**
+ * Create a work stealing executor. Every worker owns its own queue, jobs submitted by
+ * a worker stay on that worker's queue, jobs submitted from other threads are spread
+ * over the workers. A worker that runs out of jobs steals from the others before it
+ * goes to sleep.
+ *
+ * @param threads the amount of workers
+ * @return the executor
+ */
+executor *executor_create(int threads) {
+    executor *instance = malloc(sizeof(executor));
+    instance->workers = malloc(sizeof(executor_worker) * threads);
+    instance->worker_count = threads;
+
+    atomic_init(&instance->next_worker, 0);
+    atomic_init(&instance->pending, 0);
+    atomic_init(&instance->sleepers, 0);
+    atomic_init(&instance->running, true);
+    atomic_init(&instance->submitted, 0);
+
+    pthread_mutex_init(&instance->sleep_lock, NULL);
+    pthread_cond_init(&instance->sleep_signal, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        executor_worker *worker = &instance->workers[i];
+        worker->id = i;
+        worker->executor = instance;
+        worker->jobs = malloc(sizeof(executor_job) * EXECUTOR_INITIAL_CAPACITY);
+        worker->head = 0;
+        worker->count = 0;
+        worker->capacity = EXECUTOR_INITIAL_CAPACITY;
+
+        atomic_init(&worker->depth, 0);
+        atomic_init(&worker->executed, 0);
+        atomic_init(&worker->stolen, 0);
+        pthread_mutex_init(&worker->lock, NULL);
+    }
+
+    // Workers are only started once every queue exists, since they steal from each other
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&instance->workers[i].thread, NULL, &executor_loop, &instance->workers[i]) != 0) {
+            log_fatal("Uh-oh! Unable to spawn executor worker %i", i);
+        }
+    }
+
+    return instance;
+}
+
+/**
+ * Submit a job, safe to call from any thread.
+ *
+ * @param executor the executor
+ * @param task the job to run
+ * @param argument the argument of the job
+ */
+void executor_submit(executor *executor, executor_task task, void *argument) {
+    executor_worker *worker = current_worker;
+
+    if (worker == NULL || worker->executor != executor) {
+        unsigned int next = atomic_fetch_add_explicit(&executor->next_worker, 1, memory_order_relaxed);
+        worker = &executor->workers[next % executor->worker_count];
+    }
+
+    executor_job job = { task, argument };
+    executor_push(worker, job);
+
+    atomic_fetch_add_explicit(&executor->submitted, 1, memory_order_relaxed);
+    atomic_fetch_add(&executor->pending, 1);
+
+    if (atomic_load(&executor->sleepers) > 0) {
+        pthread_mutex_lock(&executor->sleep_lock);
+        pthread_cond_signal(&executor->sleep_signal);
+        pthread_mutex_unlock(&executor->sleep_lock);
+    }
+}
+
+/**
+ * Append a job to the end of the worker's queue.
+ *
+ * @param worker the worker
+ * @param job the job
+ */
+void executor_push(executor_worker *worker, executor_job job) {
+    pthread_mutex_lock(&worker->lock);
+
+    if (worker->count == worker->capacity) {
+        executor_job *jobs = malloc(sizeof(executor_job) * worker->capacity * 2);
+
+        for (int i = 0; i < worker->count; i++) {
+            jobs[i] = worker->jobs[(worker->head + i) % worker->capacity];
+        }
+
+        free(worker->jobs);
+        worker->jobs = jobs;
+        worker->head = 0;
+        worker->capacity *= 2;
+    }
+
+    worker->jobs[(worker->head + worker->count) % worker->capacity] = job;
+    worker->count++;
+
+    atomic_store_explicit(&worker->depth, worker->count, memory_order_relaxed);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/**
+ * Take the oldest job off the worker's own queue, so jobs of a worker run in the
+ * order they were submitted.
+ *
+ * @param worker the worker
+ * @param job set to the job
+ * @return true, if a job was taken
+ */
+bool executor_pop(executor_worker *worker, executor_job *job) {
+    if (atomic_load_explicit(&worker->depth, memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    bool found = worker->count > 0;
+
+    if (found) {
+        *job = worker->jobs[worker->head];
+        worker->head = (worker->head + 1) % worker->capacity;
+        worker->count--;
+        atomic_store_explicit(&worker->depth, worker->count, memory_order_relaxed);
+    }
+
+    pthread_mutex_unlock(&worker->lock);
+    return found;
+}
+
+/**
+ * Steal the newest job of another worker, the victims are visited starting right
+ * after the thief so thieves don't all pile onto the first worker.
+ *
+ * @param thief the worker looking for a job
+ * @param job set to the job
+ * @return true, if a job was stolen
+ */
+bool executor_steal(executor_worker *thief, executor_job *job) {
+    executor *executor = thief->executor;
+
+    for (int i = 1; i < executor->worker_count; i++) {
+        executor_worker *victim = &executor->workers[(thief->id + i) % executor->worker_count];
+
+        if (atomic_load_explicit(&victim->depth, memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        pthread_mutex_lock(&victim->lock);
+        bool found = victim->count > 0;
+
+        if (found) {
+            victim->count--;
+            *job = victim->jobs[(victim->head + victim->count) % victim->capacity];
+            atomic_store_explicit(&victim->depth, victim->count, memory_order_relaxed);
+        }
+
+        pthread_mutex_unlock(&victim->lock);
+
+        if (found) {
+            atomic_fetch_add_explicit(&thief->stolen, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Thread callback of a worker.
+ *
+ * @param arguments the worker
+ */
+void *executor_loop(void *arguments) {
+    executor_worker *worker = arguments;
+    executor *executor = worker->executor;
+    current_worker = worker;
+
+    while (atomic_load(&executor->running)) {
+        executor_job job;
+
+        if (executor_pop(worker, &job) || executor_steal(worker, &job)) {
+            atomic_fetch_sub(&executor->pending, 1);
+            job.task(job.argument);
+            atomic_fetch_add_explicit(&worker->executed, 1, memory_order_relaxed);
+            continue;
+        }
+
+        // Submitters check for sleepers after publishing the job, so either side sees the other
+        pthread_mutex_lock(&executor->sleep_lock);
+        atomic_fetch_add(&executor->sleepers, 1);
+
+        while (atomic_load(&executor->pending) == 0 && atomic_load(&executor->running)) {
+            pthread_cond_wait(&executor->sleep_signal, &executor->sleep_lock);
+        }
+
+        atomic_fetch_sub(&executor->sleepers, 1);
+        pthread_mutex_unlock(&executor->sleep_lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the queue depth, steal and job counters of the executor.
+ *
+ * @param executor the executor
+ * @param stats the stats to fill in
+ */
+void executor_get_stats(executor *executor, executor_stats *stats) {
+    stats->workers = executor->worker_count;
+    stats->queued = 0;
+    stats->deepest_queue = 0;
+    stats->submitted = atomic_load_explicit(&executor->submitted, memory_order_relaxed);
+    stats->executed = 0;
+    stats->stolen = 0;
+
+    for (int i = 0; i < executor->worker_count; i++) {
+        executor_worker *worker = &executor->workers[i];
+        int depth = atomic_load_explicit(&worker->depth, memory_order_relaxed);
+
+        stats->queued += depth;
+        stats->executed += atomic_load_explicit(&worker->executed, memory_order_relaxed);
+        stats->stolen += atomic_load_explicit(&worker->stolen, memory_order_relaxed);
+
+        if (depth > stats->deepest_queue) {
+            stats->deepest_queue = depth;
+        }
+    }
+}
+
+/**
+ * Append a readable report of the executor's queue depth, steal and job counters.
+ *
+ * @param executor the executor
+ * @param sb the stringbuilder to write the report to
+ */
+void executor_stats_append(executor *executor, stringbuilder *sb) {
+    executor_stats stats;
+    executor_get_stats(executor, &stats);
+
+    char line[160];
+    sb_add_string(sb, "workers   queued  deepest  submitted   executed     stolen\n");
+
+    snprintf(line, sizeof(line), "%7i %8li %8i %10lu %10lu %10lu\n",
+             stats.workers,
+             stats.queued,
+             stats.deepest_queue,
+             stats.submitted,
+             stats.executed,
+             stats.stolen);
+
+    sb_add_string(sb, line);
+}
+
+/**
+ * Stop every worker once it finished its current job, jobs that are still queued
+ * are dropped.
+ *
+ * @param executor the executor
+ */
+void executor_dispose(executor *executor) {
+    pthread_mutex_lock(&executor->sleep_lock);
+    atomic_store(&executor->running, false);
+    pthread_cond_broadcast(&executor->sleep_signal);
+    pthread_mutex_unlock(&executor->sleep_lock);
+
+    for (int i = 0; i < executor->worker_count; i++) {
+        pthread_join(executor->workers[i].thread, NULL);
+    }
+
+    for (int i = 0; i < executor->worker_count; i++) {
+        pthread_mutex_destroy(&executor->workers[i].lock);
+        free(executor->workers[i].jobs);
+    }
+
+    pthread_mutex_destroy(&executor->sleep_lock);
+    pthread_cond_destroy(&executor->sleep_signal);
+    free(executor->workers);
+    free(executor);
+}
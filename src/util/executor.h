@@ -0,0 +1,64 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define EXECUTOR_INITIAL_CAPACITY 256
+
+typedef struct stringbuilder_s stringbuilder;
+
+typedef void (*executor_task)(void *argument);
+
+typedef struct executor_job_s {
+    executor_task task;
+    void *argument;
+} executor_job;
+
+typedef struct executor_worker_s {
+    int id;
+    pthread_t thread;
+    struct executor_s *executor;
+    pthread_mutex_t lock;
+    executor_job *jobs;
+    int head;
+    int count;
+    int capacity;
+    atomic_int depth;
+    atomic_ulong executed;
+    atomic_ulong stolen;
+} executor_worker;
+
+typedef struct executor_s {
+    executor_worker *workers;
+    int worker_count;
+    atomic_uint next_worker;
+    atomic_long pending;
+    atomic_int sleepers;
+    atomic_bool running;
+    atomic_ulong submitted;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t sleep_signal;
+} executor;
+
+typedef struct executor_stats_s {
+    int workers;
+    long queued;
+    int deepest_queue;
+    unsigned long submitted;
+    unsigned long executed;
+    unsigned long stolen;
+} executor_stats;
+
+executor *executor_create(int threads);
+void executor_submit(executor *executor, executor_task task, void *argument);
+void executor_push(executor_worker *worker, executor_job job);
+bool executor_pop(executor_worker *worker, executor_job *job);
+bool executor_steal(executor_worker *thief, executor_job *job);
+void *executor_loop(void *arguments);
+void executor_get_stats(executor *executor, executor_stats *stats);
+void executor_stats_append(executor *executor, stringbuilder *sb);
+void executor_dispose(executor *executor);
+
+#endif
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+
+#include "mpsc_queue.h"
+
+/**
+ * Create a lock free queue that any amount of threads can push to, but only a
+ * single thread may pop from. The queue always holds a stub node, the head is the
+ * last node that was popped.
+ *
+ * @return the queue
+ */
+mpsc_queue *mpsc_queue_create() {
+    mpsc_node *stub = malloc(sizeof(mpsc_node));
+    atomic_init(&stub->next, NULL);
+    stub->value = NULL;
+
+    mpsc_queue *queue = malloc(sizeof(mpsc_queue));
+    atomic_init(&queue->tail, stub);
+    queue->head = stub;
+    return queue;
+}
+
+/**
+ * Push a value to the queue, safe to call from any thread.
+ *
+ * @param queue the queue
+ * @param value the value to push
+ */
+void mpsc_queue_push(mpsc_queue *queue, void *value) {
+    mpsc_node *node = malloc(sizeof(mpsc_node));
+    atomic_init(&node->next, NULL);
+    node->value = value;
+
+    mpsc_node *previous = atomic_exchange_explicit(&queue->tail, node, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, node, memory_order_release);
+}
+
+/**
+ * Pop the oldest value off the queue, must only be called by the consumer thread.
+ * A push that is still in progress may not be visible yet, producers are expected
+ * to wake the consumer up after pushing.
+ *
+ * @param queue the queue
+ * @param value set to the popped value
+ * @return true, if a value was popped
+ */
+bool mpsc_queue_pop(mpsc_queue *queue, void **value) {
+    mpsc_node *head = queue->head;
+    mpsc_node *next = atomic_load_explicit(&head->next, memory_order_acquire);
+
+    if (next == NULL) {
+        return false;
+    }
+
+    *value = next->value;
+    queue->head = next;
+
+    free(head);
+    return true;
+}
+
+/**
+ * Check if the queue has nothing to pop, must only be called by the consumer thread.
+ *
+ * @param queue the queue
+ * @return true, if empty
+ */
+bool mpsc_queue_empty(mpsc_queue *queue) {
+    return atomic_load(&queue->head->next) == NULL;
+}
+
+/**
+ * Cleanup the queue, values still queued are not freed.
+ *
+ * @param queue the queue
+ */
+void mpsc_queue_dispose(mpsc_queue *queue) {
+    void *value;
+    while (mpsc_queue_pop(queue, &value));
+
+    free(queue->head);
+    free(queue);
+}
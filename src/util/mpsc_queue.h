@@ -0,0 +1,23 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+
+typedef struct mpsc_node_s {
+    _Atomic(struct mpsc_node_s *) next;
+    void *value;
+} mpsc_node;
+
+typedef struct mpsc_queue_s {
+    _Atomic(mpsc_node *) tail;
+    mpsc_node *head;
+} mpsc_queue;
+
+mpsc_queue *mpsc_queue_create();
+void mpsc_queue_push(mpsc_queue *queue, void *value);
+bool mpsc_queue_pop(mpsc_queue *queue, void **value);
+bool mpsc_queue_empty(mpsc_queue *queue);
+void mpsc_queue_dispose(mpsc_queue *queue);
+
+#endif
@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buffer.h"
+
+void ring_buffer_reverse(char *data, size_t length);
+
+/**
+ * Create a ring buffer with a fixed capacity. One extra byte is allocated past
+ * the capacity so a linearised frame can always be zero terminated in place.
+ *
+ * @param capacity the amount of bytes the buffer can hold
+ * @return the ring buffer
+ */
+ring_buffer *ring_buffer_create(size_t capacity) {
+    ring_buffer *rb = malloc(sizeof(ring_buffer));
+    rb->data = malloc(capacity + 1);
+    rb->capacity = capacity;
+    rb->head = 0;
+    rb->size = 0;
+    return rb;
+}
+
+/**
+ * Get the amount of bytes currently stored.
+ *
+ * @param rb the ring buffer
+ * @return the stored byte count
+ */
+size_t ring_buffer_size(ring_buffer *rb) {
+    return rb->size;
+}
+
+/**
+ * Get the amount of bytes that can still be written.
+ *
+ * @param rb the ring buffer
+ * @return the free byte count
+ */
+size_t ring_buffer_available(ring_buffer *rb) {
+    return rb->capacity - rb->size;
+}
+
+/**
+ * Append bytes to the end of the buffer, wrapping around if needed.
+ *
+ * @param rb the ring buffer
+ * @param data the bytes to append
+ * @param length the amount of bytes to append
+ * @return false if there was not enough room, nothing is written in that case
+ */
+bool ring_buffer_write(ring_buffer *rb, const char *data, size_t length) {
+    if (length > ring_buffer_available(rb)) {
+        return false;
+    }
+
+    size_t tail = (rb->head + rb->size) % rb->capacity;
+    size_t first = rb->capacity - tail;
+
+    if (first > length) {
+        first = length;
+    }
+
+    memcpy(rb->data + tail, data, first);
+    memcpy(rb->data, data + first, length - first);
+
+    rb->size += length;
+    return true;
+}
+
+/**
+ * Copy bytes from the front of the buffer without consuming them.
+ *
+ * @param rb the ring buffer
+ * @param out the destination
+ * @param length the maximum amount of bytes to copy
+ * @return the amount of bytes copied
+ */
+size_t ring_buffer_peek(ring_buffer *rb, char *out, size_t length) {
+    if (length > rb->size) {
+        length = rb->size;
+    }
+
+    size_t first = rb->capacity - rb->head;
+
+    if (first > length) {
+        first = length;
+    }
+
+    memcpy(out, rb->data + rb->head, first);
+    memcpy(out + first, rb->data, length - first);
+    return length;
+}
+
+/**
+ * Rotate the stored bytes so they start at the beginning of the backing
+ * storage, only moves memory when the contents wrapped around.
+ *
+ * @param rb the ring buffer
+ * @return the pointer to the first stored byte
+ */
+char *ring_buffer_linearise(ring_buffer *rb) {
+    if (rb->head == 0) {
+        return rb->data;
+    }
+
+    if (rb->head + rb->size <= rb->capacity) {
+        memmove(rb->data, rb->data + rb->head, rb->size);
+    } else {
+        // Rotate the whole storage left by head, using three reversals so no scratch memory is needed
+        ring_buffer_reverse(rb->data, rb->head);
+        ring_buffer_reverse(rb->data + rb->head, rb->capacity - rb->head);
+        ring_buffer_reverse(rb->data, rb->capacity);
+    }
+
+    rb->head = 0;
+    return rb->data;
+}
+
+/**
+ * Discard bytes from the front of the buffer.
+ *
+ * @param rb the ring buffer
+ * @param length the amount of bytes to discard
+ */
+void ring_buffer_consume(ring_buffer *rb, size_t length) {
+    if (length >= rb->size) {
+        ring_buffer_clear(rb);
+        return;
+    }
+
+    rb->head = (rb->head + length) % rb->capacity;
+    rb->size -= length;
+}
+
+/**
+ * Discard everything stored in the buffer.
+ *
+ * @param rb the ring buffer
+ */
+void ring_buffer_clear(ring_buffer *rb) {
+    rb->head = 0;
+    rb->size = 0;
+}
+
+/**
+ * Cleanup the ring buffer and its backing storage.
+ *
+ * @param rb the ring buffer
+ */
+void ring_buffer_dispose(ring_buffer *rb) {
+    free(rb->data);
+    free(rb);
+}
+
+/**
+ * Reverse a range of bytes in place.
+ *
+ * @param data the start of the range
+ * @param length the amount of bytes in the range
+ */
+void ring_buffer_reverse(char *data, size_t length) {
+    if (length < 2) {
+        return;
+    }
+
+    for (size_t i = 0, j = length - 1; i < j; i++, j--) {
+        char temp = data[i];
+        data[i] = data[j];
+        data[j] = temp;
+    }
+}
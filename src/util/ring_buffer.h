@@ -0,0 +1,24 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct ring_buffer_s {
+    char *data;
+    size_t capacity;
+    size_t head;
+    size_t size;
+} ring_buffer;
+
+ring_buffer *ring_buffer_create(size_t capacity);
+size_t ring_buffer_size(ring_buffer *rb);
+size_t ring_buffer_available(ring_buffer *rb);
+bool ring_buffer_write(ring_buffer *rb, const char *data, size_t length);
+size_t ring_buffer_peek(ring_buffer *rb, char *out, size_t length);
+char *ring_buffer_linearise(ring_buffer *rb);
+void ring_buffer_consume(ring_buffer *rb, size_t length);
+void ring_buffer_clear(ring_buffer *rb);
+void ring_buffer_dispose(ring_buffer *rb);
+
+#endif
@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <time.h>
+
+#include "log.h"
+#include "scheduler.h"
+
+#define SCHEDULER_INITIAL_CAPACITY 64
+#define NANOS_PER_MILLI 1000000ULL
+#define NANOS_PER_SECOND 1000000000ULL
+
+void scheduler_swap(scheduler *scheduler, int first, int second);
+void scheduler_sift_up(scheduler *scheduler, int index);
+void scheduler_sift_down(scheduler *scheduler, int index);
+void scheduler_remove_at(scheduler *scheduler, int index);
+
+/**
+ * Create a scheduler which runs tasks at a fixed rate. Every task lives in a min-heap
+ * ordered by deadline and a single thread sleeps until the earliest deadline, so no
+ * thread is ever held by a task that is waiting for its next run.
+ *
+ * @return the scheduler
+ */
+scheduler *scheduler_create() {
+    scheduler *instance = malloc(sizeof(scheduler));
+    instance->heap = malloc(sizeof(scheduled_task*) * SCHEDULER_INITIAL_CAPACITY);
+    instance->count = 0;
+    instance->capacity = SCHEDULER_INITIAL_CAPACITY;
+    instance->running = true;
+    instance->running_task = NULL;
+
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+
+    pthread_mutex_init(&instance->lock, NULL);
+    pthread_cond_init(&instance->wakeup, &attributes);
+    pthread_cond_init(&instance->idle, NULL);
+    pthread_condattr_destroy(&attributes);
+
+    if (pthread_create(&instance->thread, NULL, &scheduler_loop, instance) != 0) {
+        log_fatal("Uh-oh! Unable to spawn scheduler thread");
+    }
+
+    return instance;
+}
+
+/**
+ * Get the monotonic time in nanoseconds.
+ *
+ * @return the time
+ */
+uint64_t scheduler_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NANOS_PER_SECOND + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * Schedule a task. Callbacks are run by the scheduler thread without the scheduler locked,
+ * they should only hand work off to other threads since they hold up every other task.
+ *
+ * @param scheduler the scheduler
+ * @param callback the callback to run
+ * @param argument the argument of the callback
+ * @param delay_millis the delay before the first run
+ * @param period_millis the interval between runs, 0 to only run once
+ * @return the task, which stays valid until it was cancelled, even after a task that only
+ *         runs once has run
+ */
+scheduled_task *scheduler_schedule(scheduler *scheduler, scheduler_callback callback, void *argument, uint64_t delay_millis, uint64_t period_millis) {
+    scheduled_task *task = malloc(sizeof(scheduled_task));
+    task->callback = callback;
+    task->argument = argument;
+    task->deadline = scheduler_now() + delay_millis * NANOS_PER_MILLI;
+    task->period = period_millis * NANOS_PER_MILLI;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    if (scheduler->count == scheduler->capacity) {
+        scheduler->capacity *= 2;
+        scheduler->heap = realloc(scheduler->heap, sizeof(scheduled_task*) * scheduler->capacity);
+    }
+
+    task->heap_index = scheduler->count;
+    scheduler->heap[scheduler->count++] = task;
+    scheduler_sift_up(scheduler, task->heap_index);
+
+    // Only wake the thread up if it's sleeping for longer than it should
+    if (task->heap_index == 0) {
+        pthread_cond_signal(&scheduler->wakeup);
+    }
+
+    pthread_mutex_unlock(&scheduler->lock);
+    return task;
+}
+
+/**
+ * Cancel a task and free it, the callback is guaranteed to not be running anymore
+ * once this returns. Every task has to be cancelled exactly once by its owner, this
+ * includes tasks that only run once and already ran.
+ *
+ * @param scheduler the scheduler
+ * @param task the task
+ * @return true, if the task was still scheduled
+ */
+bool scheduler_cancel(scheduler *scheduler, scheduled_task *task) {
+    pthread_mutex_lock(&scheduler->lock);
+
+    bool scheduled = task->heap_index >= 0;
+
+    if (scheduled) {
+        scheduler_remove_at(scheduler, task->heap_index);
+    }
+
+    // A callback cancelling its own task can't wait for itself to finish
+    while (scheduler->running_task == task && !pthread_equal(pthread_self(), scheduler->thread)) {
+        pthread_cond_wait(&scheduler->idle, &scheduler->lock);
+    }
+
+    pthread_mutex_unlock(&scheduler->lock);
+
+    free(task);
+    return scheduled;
+}
+
+/**
+ * Thread callback of the scheduler, runs every task that is due and sleeps until the
+ * next deadline. A due task is taken off the heap, or moved to its next deadline, under
+ * the lock and its callback is run after unlocking. A task that fell more than a whole
+ * period behind skips the missed runs instead of running them back to back.
+ *
+ * @param arguments the scheduler
+ */
+void *scheduler_loop(void *arguments) {
+    scheduler *scheduler = arguments;
+
+    pthread_mutex_lock(&scheduler->lock);
+
+    while (scheduler->running) {
+        if (scheduler->count == 0) {
+            pthread_cond_wait(&scheduler->wakeup, &scheduler->lock);
+            continue;
+        }
+
+        scheduled_task *task = scheduler->heap[0];
+        uint64_t now = scheduler_now();
+
+        if (task->deadline > now) {
+            struct timespec until;
+            until.tv_sec = (time_t) (task->deadline / NANOS_PER_SECOND);
+            until.tv_nsec = (long) (task->deadline % NANOS_PER_SECOND);
+
+            pthread_cond_timedwait(&scheduler->wakeup, &scheduler->lock, &until);
+            continue;
+        }
+
+        if (task->period == 0) {
+            scheduler_remove_at(scheduler, 0);
+        } else {
+            task->deadline += task->period;
+
+            if (task->deadline + task->period <= now) {
+                task->deadline = now + task->period;
+            }
+
+            scheduler_sift_down(scheduler, 0);
+        }
+
+        // The task can't be freed while it's running, scheduler_cancel waits for it
+        scheduler->running_task = task;
+        pthread_mutex_unlock(&scheduler->lock);
+
+        task->callback(task->argument);
+
+        pthread_mutex_lock(&scheduler->lock);
+        scheduler->running_task = NULL;
+        pthread_cond_broadcast(&scheduler->idle);
+    }
+
+    pthread_mutex_unlock(&scheduler->lock);
+    return NULL;
+}
+
+/**
+ * Swap two tasks in the heap.
+ *
+ * @param scheduler the scheduler
+ * @param first the first index
+ * @param second the second index
+ */
+void scheduler_swap(scheduler *scheduler, int first, int second) {
+    scheduled_task *task = scheduler->heap[first];
+
+    scheduler->heap[first] = scheduler->heap[second];
+    scheduler->heap[second] = task;
+
+    scheduler->heap[first]->heap_index = first;
+    scheduler->heap[second]->heap_index = second;
+}
+
+/**
+ * Move a task up the heap until its parent is due earlier.
+ *
+ * @param scheduler the scheduler
+ * @param index the index of the task
+ */
+void scheduler_sift_up(scheduler *scheduler, int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (scheduler->heap[parent]->deadline <= scheduler->heap[index]->deadline) {
+            break;
+        }
+
+        scheduler_swap(scheduler, parent, index);
+        index = parent;
+    }
+}
+
+/**
+ * Move a task down the heap until its children are due later.
+ *
+ * @param scheduler the scheduler
+ * @param index the index of the task
+ */
+void scheduler_sift_down(scheduler *scheduler, int index) {
+    while (true) {
+        int smallest = index;
+        int left = index * 2 + 1;
+        int right = left + 1;
+
+        if (left < scheduler->count && scheduler->heap[left]->deadline < scheduler->heap[smallest]->deadline) {
+            smallest = left;
+        }
+
+        if (right < scheduler->count && scheduler->heap[right]->deadline < scheduler->heap[smallest]->deadline) {
+            smallest = right;
+        }
+
+        if (smallest == index) {
+            break;
+        }
+
+        scheduler_swap(scheduler, index, smallest);
+        index = smallest;
+    }
+}
+
+/**
+ * Remove the task at the given index from the heap, the task is not freed.
+ *
+ * @param scheduler the scheduler
+ * @param index the index of the task
+ */
+void scheduler_remove_at(scheduler *scheduler, int index) {
+    scheduled_task *task = scheduler->heap[index];
+    int last = --scheduler->count;
+
+    if (index != last) {
+        scheduler_swap(scheduler, index, last);
+        scheduler_sift_down(scheduler, index);
+        scheduler_sift_up(scheduler, index);
+    }
+
+    task->heap_index = -1;
+}
+
+/**
+ * Stop the scheduler thread and free every task that is still scheduled, tasks that
+ * only ran once are left to their owners.
+ *
+ * @param scheduler the scheduler
+ */
+void scheduler_dispose(scheduler *scheduler) {
+    pthread_mutex_lock(&scheduler->lock);
+    scheduler->running = false;
+    pthread_cond_signal(&scheduler->wakeup);
+    pthread_mutex_unlock(&scheduler->lock);
+
+    pthread_join(scheduler->thread, NULL);
+
+    for (int i = 0; i < scheduler->count; i++) {
+        free(scheduler->heap[i]);
+    }
+
+    pthread_mutex_destroy(&scheduler->lock);
+    pthread_cond_destroy(&scheduler->wakeup);
+    pthread_cond_destroy(&scheduler->idle);
+    free(scheduler->heap);
+    free(scheduler);
+}
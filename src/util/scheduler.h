@@ -0,0 +1,37 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+typedef void (*scheduler_callback)(void *argument);
+
+typedef struct scheduled_task_s {
+    scheduler_callback callback;
+    void *argument;
+    uint64_t deadline;
+    uint64_t period;
+    int heap_index;
+} scheduled_task;
+
+typedef struct scheduler_s {
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+    pthread_cond_t idle;
+    pthread_t thread;
+    scheduled_task **heap;
+    scheduled_task *running_task;
+    int count;
+    int capacity;
+    bool running;
+} scheduler;
+
+scheduler *scheduler_create();
+scheduled_task *scheduler_schedule(scheduler *scheduler, scheduler_callback callback, void *argument, uint64_t delay_millis, uint64_t period_millis);
+bool scheduler_cancel(scheduler *scheduler, scheduled_task *task);
+void *scheduler_loop(void *arguments);
+uint64_t scheduler_now();
+void scheduler_dispose(scheduler *scheduler);
+
+#endif
@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared_buffer.h"
+
+/**
+ * Create an immutable, reference counted copy of the given bytes. The creator
+ * holds the first reference.
+ *
+ * @param data the bytes to copy
+ * @param length the amount of bytes
+ * @return the shared buffer
+ */
+shared_buffer *shared_buffer_create(const char *data, size_t length) {
+    shared_buffer *buffer = malloc(sizeof(shared_buffer) + length);
+    atomic_init(&buffer->references, 1);
+    buffer->length = length;
+    memcpy(buffer->data, data, length);
+    return buffer;
+}
+
+/**
+ * Create a shared buffer of the given length for the creator to fill in, it must not
+ * be changed anymore once it's shared.
+ *
+ * @param length the amount of bytes
+ * @return the shared buffer
+ */
+shared_buffer *shared_buffer_allocate(size_t length) {
+    shared_buffer *buffer = malloc(sizeof(shared_buffer) + length);
+    atomic_init(&buffer->references, 1);
+    buffer->length = length;
+    return buffer;
+}
+
+/**
+ * Take another reference to the buffer.
+ *
+ * @param buffer the shared buffer
+ * @return the same buffer
+ */
+shared_buffer *shared_buffer_retain(shared_buffer *buffer) {
+    atomic_fetch_add_explicit(&buffer->references, 1, memory_order_relaxed);
+    return buffer;
+}
+
+/**
+ * Drop a reference to the buffer, it's freed once the last reference is gone.
+ *
+ * @param buffer the shared buffer
+ */
+void shared_buffer_release(shared_buffer *buffer) {
+    if (buffer == NULL) {
+        return;
+    }
+
+    if (atomic_fetch_sub_explicit(&buffer->references, 1, memory_order_acq_rel) == 1) {
+        free(buffer);
+    }
+}
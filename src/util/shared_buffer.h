@@ -0,0 +1,18 @@
+#ifndef SHARED_BUFFER_H
+#define SHARED_BUFFER_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+typedef struct shared_buffer_s {
+    atomic_int references;
+    size_t length;
+    char data[];
+} shared_buffer;
+
+shared_buffer *shared_buffer_create(const char *data, size_t length);
+shared_buffer *shared_buffer_allocate(size_t length);
+shared_buffer *shared_buffer_retain(shared_buffer *buffer);
+void shared_buffer_release(shared_buffer *buffer);
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "util/stringbuilder.h"
 #include "util/encoding/vl64encoding.h"
+#include "util/encoding/decimalencoding.h"
 
 /**
  * Creates a stringbuilder instance
@@ -9,17 +10,29 @@
  */
 stringbuilder *sb_create() {
     stringbuilder *sb = malloc(sizeof(stringbuilder));
-    sb->capacity = 1024;
+    sb->capacity = SB_DEFAULT_CAPACITY;
     
     sb->data = malloc(sb->capacity * sizeof(char));
-    memset(sb->data, 0, sizeof(sb->data));
+    sb->data[0] = '\0';
 
     sb->index = 0;
     return sb;
 }
 
+/**
+ * Empty the stringbuilder so it can be reused, the buffer is kept.
+ *
+ * @param sb the stringbuilder
+ */
+void sb_reset(stringbuilder *sb) {
+    sb->index = 0;
+    sb->data[0] = '\0';
+}
+
 /**
  * Checks the capacity of the buffer, if there is not a sufficient amount, the buffer will be expanded.
+ * The buffer at least doubles so a message built piece by piece is only copied a few times.
+ *
  * @param sb the stringbuilder
  * @param length the new length required
  */
@@ -28,40 +41,91 @@ void sb_ensure_capacity(stringbuilder *sb, int length) {
         return;
     }
 
-    sb->capacity = sb->capacity + length;
+    int capacity = sb->capacity * 2;
+
+    if (capacity < sb->index + length) {
+        capacity = sb->index + length;
+    }
+
+    sb->capacity = capacity;
     sb->data = realloc(sb->data, sb->capacity * sizeof(char));
 }
 
 /**
- * Adds a string to the stringbuilder
+ * Make sure the stringbuilder can hold the given total length without growing again,
+ * for messages of which the size is roughly known up front.
+ *
  * @param sb the stringbuilder
- * @param data the string
+ * @param length the total length to reserve room for
  */
-void sb_add_string(stringbuilder *sb, const char *data) {
-    if (data == NULL) {
+void sb_reserve(stringbuilder *sb, int length) {
+    if (sb->capacity > length) {
         return;
     }
 
-    sb_ensure_capacity(sb, strlen(data) + 1); //+1 for terminated string
+    sb->capacity = length + 1;
+    sb->data = realloc(sb->data, sb->capacity * sizeof(char));
+}
 
-    for (int i = 0; i < strlen(data); i++) {
-        sb->data[sb->index++] = data[i];
+/**
+ * Give back memory of a stringbuilder that grew larger than it usually has to be,
+ * the data it holds is kept.
+ *
+ * @param sb the stringbuilder
+ * @param capacity the capacity to shrink to
+ */
+void sb_shrink(stringbuilder *sb, int capacity) {
+    if (capacity <= sb->index) {
+        capacity = sb->index + 1;
     }
 
+    if (capacity >= sb->capacity) {
+        return;
+    }
+
+    sb->capacity = capacity;
+    sb->data = realloc(sb->data, sb->capacity * sizeof(char));
+}
+
+/**
+ * Adds raw bytes to the stringbuilder
+ *
+ * @param sb the stringbuilder
+ * @param data the bytes
+ * @param length the amount of bytes
+ */
+void sb_add_bytes(stringbuilder *sb, const char *data, int length) {
+    sb_ensure_capacity(sb, length + 1); //+1 for terminated string
+
+    memcpy(sb->data + sb->index, data, (size_t) length);
+    sb->index += length;
+
     // zero terminated string
     sb->data[sb->index] = '\0';
 }
 
+/**
+ * Adds a string to the stringbuilder
+ * @param sb the stringbuilder
+ * @param data the string
+ */
+void sb_add_string(stringbuilder *sb, const char *data) {
+    if (data == NULL) {
+        return;
+    }
+
+    sb_add_bytes(sb, data, (int) strlen(data));
+}
+
 /**
  * Adds an integer to the stringbuilder
  * @param sb the stringbuilder
  * @param integer the int
  */
 void sb_add_int(stringbuilder *sb, int integer) {
-    char data[11];
-    sprintf(data, "%i", integer);
-    data[10] = '\0';
-    sb_add_string(sb, data);
+    sb_ensure_capacity(sb, DECIMAL_INT_MAX_LENGTH + 1);
+    sb->index += decimal_encode_int(sb->data + sb->index, integer);
+    sb->data[sb->index] = '\0';
 }
 
 /**
@@ -70,22 +134,33 @@ void sb_add_int(stringbuilder *sb, int integer) {
  * @param integer the int
  */
 void sb_add_wired(stringbuilder *sb, int integer) {
-    char *encoded = vl64_encode(integer);
-    sb_add_string(sb, encoded);
-    free(encoded);
+    char encoded[VL64_MAX_LENGTH];
+    sb_add_bytes(sb, encoded, vl64_encode_into(encoded, integer));
+}
+
+/**
+ * Adds several wired integers to the stringbuilder, encoded straight into its buffer
+ *
+ * @param sb the stringbuilder
+ * @param integers the ints
+ * @param count the amount of ints
+ */
+void sb_add_wired_many(stringbuilder *sb, const int *integers, int count) {
+    sb_ensure_capacity(sb, count * VL64_MAX_LENGTH + 1);
+    sb->index += vl64_encode_many(sb->data + sb->index, integers, count);
+    sb->data[sb->index] = '\0';
 }
 
 /**
- * Adds an double to the stringbuilder
+ * Adds an double to the stringbuilder with two decimals
  *
  * @param sb the stringbuilder
  * @param d the double
  */
 void sb_add_float(stringbuilder *sb, double d) {
-    char data[11];
-    sprintf(data, "%.2f", d);
-    data[10] = '\0';
-    sb_add_string(sb, data);
+    sb_ensure_capacity(sb, DECIMAL_FIXED_MAX_LENGTH + 1);
+    sb->index += decimal_encode_fixed(sb->data + sb->index, d);
+    sb->data[sb->index] = '\0';
 }
 
 /**
@@ -94,10 +169,9 @@ void sb_add_float(stringbuilder *sb, double d) {
  * @param integer the int
  */
 void sb_add_char(stringbuilder *sb, int num) {
-    char data[2];
-    data[0] = (char)num;
-    data[1] = '\0';
-    sb_add_string(sb, data);
+    sb_ensure_capacity(sb, 2);
+    sb->data[sb->index++] = (char) num;
+    sb->data[sb->index] = '\0';
 }
 
 /**
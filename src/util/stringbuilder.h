@@ -1,17 +1,24 @@
 #ifndef STRINGBUILDER_H
 #define STRINGBUILDER_H
 
+#define SB_DEFAULT_CAPACITY 1024
+
 typedef struct stringbuilder_s {
     char *data;
-    int index;
+    int index; // the length of the data, the data may contain NUL bytes
     int capacity;
 } stringbuilder;
 
 stringbuilder *sb_create();
+void sb_reset(stringbuilder*);
 void sb_ensure_capacity(stringbuilder*, int);
+void sb_reserve(stringbuilder*, int);
+void sb_shrink(stringbuilder*, int);
+void sb_add_bytes(stringbuilder*, const char*, int);
 void sb_add_string(stringbuilder*, const char*);
 void sb_add_int(stringbuilder*, int);
 void sb_add_wired(stringbuilder*, int);
+void sb_add_wired_many(stringbuilder*, const int*, int);
 void sb_add_float(stringbuilder*, double);
 void sb_add_char(stringbuilder*, int);
 void sb_add_string_delimeter(stringbuilder *sb, const char *data, char delim);
@@ -2,56 +2,30 @@
 #include <stdlib.h>
 #include <unistd.h>
 
-#include "log.h"
-#include "thpool.h"
-#include "hashtable.h"
-#include "list.h"
-
-#include "game/room/room_manager.h"
-#include "game/room/room.h"
+#include "util/actor.h"
+#include "util/executor.h"
+#include "util/scheduler.h"
+#include "util/configuration/configuration.h"
 
 #include "shared.h"
 
 /**
- * Create runnable instance
- *
- * @return runnable struct
- */
-runnable *create_runnable() {
-    runnable *r = malloc(sizeof(runnable));
-    r->room_id = 0;
-    r->request = NULL;
-    r->self = r;
-    r->millis = 500;
-    return r;
-}
-
-/**
- * Schedule a task for the room at an interval.
- *
- * @param run the runnable task
+ * Create the work stealing executor with one worker per core (unless configured
+ * otherwise), along with the hotel actor which owns every bit of state that doesn't
+ * belong to a room and the scheduler which fires the room ticks.
  */
-void do_room_task(runnable *run) {
-    room *room = room_manager_get_by_id(run->room_id);
-
-    if (room == NULL || list_size(room->users) == 0) {
-        if (room != NULL) {
-            room->room_schedule_job = NULL;
-        }
+void create_thread_pool() {
+    int threads = configuration_get_int("executor.threads");
 
-        log_info("Room %i unloaded.", run->room_id);
+    if (threads <= 0) {
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
 
-        free(run);
-        return;
+    if (threads <= 0) {
+        threads = 1;
     }
 
-    run->request(room);
-    usleep(run->millis * 1000);
-    thpool_add_work(global.thread_manager.pool, (void *) do_room_task, run);
+    global.thread_manager.executor = executor_create(threads);
+    global.thread_manager.hotel = actor_create(NULL);
+    global.thread_manager.scheduler = scheduler_create();
 }
-/**
- * Create a thread pool with 32 threads allocated.
- */
-void create_thread_pool() {
-    global.thread_manager.pool = thpool_init(32);
-}
\ No newline at end of file
@@ -3,28 +3,21 @@
 
 #include "game/room/room.h"
 
-typedef struct hashtable_s HashTable;
-typedef struct runnable_s runnable;
-typedef struct thpool_* threadpool;
+#define ROOM_TICK_MILLIS 500
 
-typedef void (*thread_request)(room*);
+typedef struct hashtable_s HashTable;
+typedef struct executor_s executor;
+typedef struct actor_s actor;
+typedef struct scheduler_s scheduler;
 
 struct thread_manager {
     HashTable *tasks;
-    threadpool pool;
+    executor *executor;
+    actor *hotel;
+    scheduler *scheduler;
 };
 
-typedef struct runnable_s {
-    thread_request request;
-    runnable *self;
-    int room_id;
-    int millis;
-    bool stop;
-} runnable;
-
-void do_room_task(runnable*);
 void create_thread_pool();
 int threading_has_room(int);
-runnable *create_runnable();
 
-#endif
\ No newline at end of file
+#endif
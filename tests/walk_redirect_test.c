@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "list.h"
+
+#include "shared.h"
+
+#include "game/player/player.h"
+
+#include "game/pathfinder/coord.h"
+#include "game/pathfinder/path_request.h"
+
+#include "game/room/room.h"
+#include "game/room/room_user.h"
+#include "game/room/tasks/walk_task.h"
+
+#include "game/room/mapping/room_model.h"
+#include "game/room/mapping/room_map.h"
+
+#include "util/executor.h"
+
+#define TEST_MAX_CYCLES 64
+
+static atomic_bool test_executor_blocked;
+
+/**
+ * Create an open room of 8 by 8 tiles, without items or a database behind it.
+ *
+ * @return the room
+ */
+static room *test_room_create() {
+    room_model *model = calloc(1, sizeof(room_model));
+    model->model_id = strdup("test");
+    model->model_name = strdup("test");
+    model->heightmap = strdup("00000000\r00000000\r00000000\r00000000\r00000000\r00000000\r00000000\r00000000");
+    list_new(&model->public_items);
+    room_model_parse(model);
+
+    room *instance = calloc(1, sizeof(room));
+    instance->room_data = calloc(1, sizeof(room_data));
+    instance->room_data->model_data = model;
+    list_new(&instance->users);
+    list_new(&instance->items);
+
+    room_map_init(instance);
+    return instance;
+}
+
+/**
+ * Put a player in the room on the given tile, nothing is sent to it.
+ *
+ * @param instance the room
+ * @param x the x coordinate
+ * @param y the y coordinate
+ * @return the player
+ */
+static session *test_player_create(room *instance, int x, int y) {
+    session *player = calloc(1, sizeof(session));
+    player->disconnected = true;
+    player->player_data = calloc(1, sizeof(player_data));
+    player->player_data->pool_figure = strdup("");
+
+    player->room_user = room_user_create(player);
+    player->room_user->room = instance;
+    player->room_user->position->x = x;
+    player->room_user->position->y = y;
+
+    list_add(instance->users, player);
+    room_map_set_entity(instance, x, y, player->room_user);
+    return player;
+}
+
+/**
+ * Run a walk task cycle, once the search the user asked for is done so the test
+ * doesn't depend on how fast the executor is.
+ *
+ * @param instance the room
+ * @param player the player
+ */
+static void test_walk_cycle(room *instance, session *player) {
+    path_request *request = player->room_user->path_request;
+
+    while (request != NULL && !atomic_load(&request->done)) {
+        usleep(1000);
+    }
+
+    walk_task(instance);
+}
+
+/**
+ * Keep the executor busy until the test lets go, so searches submitted meanwhile
+ * are still running when the walk task comes by.
+ *
+ * @param argument unused
+ */
+static void test_block_executor(void *argument) {
+    while (atomic_load(&test_executor_blocked)) {
+        usleep(1000);
+    }
+}
+
+int main() {
+    global.thread_manager.executor = executor_create(1);
+
+    room *instance = test_room_create();
+    session *player = test_player_create(instance, 0, 0);
+    room_user *room_user = player->room_user;
+
+    walk_to(room_user, 7, 0);
+
+    for (int i = 0; i < 3; i++) {
+        test_walk_cycle(instance, player);
+    }
+
+    if (!room_user->is_walking || room_user->position->x == 0) {
+        fprintf(stderr, "user didn't start walking to 7,0, stands on %i,%i\n", room_user->position->x, room_user->position->y);
+        return EXIT_FAILURE;
+    }
+
+    // Change direction halfway, the old goal must never be reached
+    int redirect_x = room_user->position->x;
+
+    atomic_store(&test_executor_blocked, true);
+    executor_submit(global.thread_manager.executor, test_block_executor, NULL);
+
+    walk_to(room_user, 0, 7);
+    walk_task(instance);
+
+    atomic_store(&test_executor_blocked, false);
+
+    for (int i = 0; i < TEST_MAX_CYCLES && (room_user->is_walking || room_user->path_request != NULL); i++) {
+        test_walk_cycle(instance, player);
+
+        if (room_user->position->x > redirect_x + 1) {
+            fprintf(stderr, "user kept walking the old path, stands on %i,%i\n", room_user->position->x, room_user->position->y);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (room_user->position->x != 0 || room_user->position->y != 7) {
+        fprintf(stderr, "user didn't reach 0,7, stands on %i,%i\n", room_user->position->x, room_user->position->y);
+        return EXIT_FAILURE;
+    }
+
+    executor_dispose(global.thread_manager.executor);
+    return EXIT_SUCCESS;
+}